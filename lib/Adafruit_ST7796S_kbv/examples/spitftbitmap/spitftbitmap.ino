@@ -18,6 +18,7 @@
 #include "Adafruit_ST7796S_kbv.h"
 #include <SPI.h>
 #include <SD.h>
+#include <PixelConvert.h> // Batch BGR888 -> RGB565 conversion
 
 // TFT display and SD card will share the hardware SPI interface.
 // Hardware SPI pins are specific to the Arduino board type and
@@ -68,11 +69,10 @@ void bmpDraw(char *filename, uint8_t x, uint16_t y) {
   uint32_t bmpImageoffset;        // Start of image data in file
   uint32_t rowSize;               // Not always = bmpWidth; may have padding
   uint8_t  sdbuffer[3*BUFFPIXEL]; // pixel buffer (R+G+B per pixel)
-  uint8_t  buffidx = sizeof(sdbuffer); // Current position in sdbuffer
+  uint16_t pixels[BUFFPIXEL];     // the same block as big-endian RGB565
   boolean  goodBmp = false;       // Set to true on valid header parse
   boolean  flip    = true;        // BMP is stored bottom-to-top
   int      w, h, row, col;
-  uint8_t  r, g, b;
   uint32_t pos = 0, startTime = millis();
 
   if((x >= tft.width()) || (y >= tft.height())) return;
@@ -144,25 +144,21 @@ void bmpDraw(char *filename, uint8_t x, uint16_t y) {
           if(bmpFile.position() != pos) { // Need seek?
             tft.endWrite(); // End TFT transaction
             bmpFile.seek(pos);
-            buffidx = sizeof(sdbuffer); // Force buffer reload
             tft.startWrite(); // Start new TFT transaction
           }
 
-          for (col=0; col<w; col++) { // For each pixel...
-            // Time to read more pixel data?
-            if (buffidx >= sizeof(sdbuffer)) { // Indeed
-              tft.endWrite(); // End TFT transaction
-              bmpFile.read(sdbuffer, sizeof(sdbuffer));
-              buffidx = 0; // Set index to beginning
-              tft.startWrite(); // Start new TFT transaction
-            }
-
-            // Convert pixel from BMP to TFT format, push to display
-            b = sdbuffer[buffidx++];
-            g = sdbuffer[buffidx++];
-            r = sdbuffer[buffidx++];
-            tft.pushColor(tft.color565(r,g,b));
-          } // end pixel
+          for (col=0; col<w; col+=BUFFPIXEL) { // For each block of pixels...
+            int n = w - col;
+            if (n > BUFFPIXEL) n = BUFFPIXEL;
+            tft.endWrite(); // End TFT transaction
+            bmpFile.read(sdbuffer, n * 3);
+            tft.startWrite(); // Start new TFT transaction
+
+            // Convert the block from BMP to big-endian RGB565 and push it
+            // to the display in one go
+            convertBgr888ToRgb565(sdbuffer, pixels, n);
+            tft.writePixels(pixels, n, true, true);
+          } // end block
         } // end scanline
         tft.endWrite(); // End last TFT transaction
         Serial.print(F("Loaded in "));
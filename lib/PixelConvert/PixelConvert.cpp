@@ -0,0 +1,9 @@
+#include "PixelConvert.h"
+
+// One pixel at a time: the row is a few hundred pixels and the SD read
+// and SPI push around it dominate, so this stays the plain loop
+void convertBgr888ToRgb565(const uint8_t *src, uint16_t *dst, size_t count) {
+  for (size_t i = 0; i < count; ++i, src += 3) {
+    dst[i] = rgb565Swapped(src[2], src[1], src[0]);
+  }
+}
@@ -0,0 +1,17 @@
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// RGB565 with the two bytes swapped, i.e. the order the panel expects on the
+// wire when the buffer is pushed with swap bytes turned off.
+static inline uint16_t rgb565Swapped(uint8_t r, uint8_t g, uint8_t b) {
+  return (r & 0xF8) | (g >> 5) | ((g & 0x1C) << 11) | ((b & 0xF8) << 5);
+}
+
+// Convert count BMP pixels (B, G, R byte triplets) into byte-swapped RGB565.
+// src needs no particular alignment.
+void convertBgr888ToRgb565(const uint8_t *src, uint16_t *dst, size_t count);
+
+#endif
@@ -0,0 +1,101 @@
+#include <Arduino.h>
+#include "astro.h"
+#include "timesync.h"
+
+#define ASTRO_STEP_S 3600
+#define ASTRO_BISECTIONS 10
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+static int32_t daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  int32_t era = (y >= 0 ? y : y - 399) / 400;
+  int32_t yoe = y - era * 400;
+  int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+bool localDayOf(time_t now, LocalDay &out) {
+  if (!clockValid(now)) return false;
+  struct tm tm;
+  localtime_r(&now, &tm);
+  out.dayNumber = daysFromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+  out.midnightEpoch = now - (tm.tm_hour * 3600L + tm.tm_min * 60L + tm.tm_sec);
+  return true;
+}
+
+LocalDay localDayAfter(const LocalDay &d, int days) {
+  LocalDay next;
+  next.dayNumber = d.dayNumber + days;
+  next.midnightEpoch = d.midnightEpoch + days * 86400L;
+  return next;
+}
+
+double astroWrap360(double deg) {
+  deg = fmod(deg, 360.0);
+  return deg < 0 ? deg + 360.0 : deg;
+}
+
+double astroWrap180(double deg) {
+  deg = astroWrap360(deg);
+  return deg > 180.0 ? deg - 360.0 : deg;
+}
+
+double astroSiderealDeg(double days) {
+  return astroWrap360(280.46061837 + 360.98564736629 * days);
+}
+
+Equatorial astroFromEcliptic(double days, double lonDeg, double latDeg) {
+  double eps = 23.4393 - 3.563e-7 * days;
+  double sl = astroSin(lonDeg), cl = astroCos(lonDeg);
+  double sb = astroSin(latDeg), cb = astroCos(latDeg);
+  double se = astroSin(eps), ce = astroCos(eps);
+  Equatorial eq;
+  eq.ra = astroWrap360(atan2(sl * ce * cb - sb * se, cl * cb) * (180 / M_PI));
+  eq.dec = asin(sb * ce + cb * se * sl) * (180 / M_PI);
+  return eq;
+}
+
+double astroHourAngle(const Equatorial &eq, const GeoPoint &p, double days) {
+  return astroWrap180(astroSiderealDeg(days) + p.lon - eq.ra);
+}
+
+double astroAltitude(const Equatorial &eq, const GeoPoint &p, double days) {
+  double h = astroHourAngle(eq, p, days);
+  double s = astroSin(p.lat) * astroSin(eq.dec) + astroCos(p.lat) * astroCos(eq.dec) * astroCos(h);
+  return asin(s) * (180 / M_PI);
+}
+
+double astroSunLongitude(double days) {
+  double g = 357.529 + 0.98560028 * days;
+  double q = 280.459 + 0.98564736 * days;
+  return astroWrap360(q + 1.915 * astroSin(g) + 0.020 * astroSin(2 * g));
+}
+
+uint16_t astroCrossing(AstroCurve curve, void *ctx, const LocalDay &day, int rising) {
+  double a = day.midnightEpoch;
+  double fa = curve(ctx, a);
+  for (int step = 0; step < 86400 / ASTRO_STEP_S; ++step) {
+    double b = a + ASTRO_STEP_S;
+    double fb = curve(ctx, b);
+    bool crosses = rising > 0 ? (fa < 0 && fb >= 0) : (fa >= 0 && fb < 0);
+    if (crosses && fabs(fb - fa) < 180) {
+      double lo = a, hi = b, flo = fa;
+      for (int i = 0; i < ASTRO_BISECTIONS; ++i) {
+        double mid = (lo + hi) / 2;
+        double fm = curve(ctx, mid);
+        if ((fm < 0) == (flo < 0)) {
+          lo = mid;
+          flo = fm;
+        } else {
+          hi = mid;
+        }
+      }
+      uint32_t minute = (uint32_t)(((lo + hi) / 2 - day.midnightEpoch) / 60 + 0.5);
+      return minute < 1440 ? minute : 1439;
+    }
+    a = b;
+    fa = fb;
+  }
+  return SAMPLE_NO_TIME;
+}
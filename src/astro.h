@@ -0,0 +1,67 @@
+#ifndef ASTRO_H
+#define ASTRO_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "weathersample.h"
+
+// Where a location is, in degrees, north and east positive
+struct GeoPoint {
+  float lat;
+  float lon;
+};
+
+// The local calendar day an instant falls in, under the rules set with
+// configTzTime(). Events are reported as minutes since its midnight.
+struct LocalDay {
+  int32_t dayNumber;      // local days since 1970-01-01
+  uint32_t midnightEpoch; // UTC epoch of local midnight
+};
+
+// False until the clock has been set
+bool localDayOf(time_t now, LocalDay &out);
+// `days` later, at the same UTC offset
+LocalDay localDayAfter(const LocalDay &d, int days);
+
+// Days since 2000-01-01 12:00 UTC (J2000.0)
+inline double astroDays(double epoch) {
+  return (epoch - 946728000.0) / 86400.0;
+}
+
+double astroWrap360(double deg);
+double astroWrap180(double deg);
+inline double astroSin(double deg) {
+  return sin(deg * (M_PI / 180));
+}
+inline double astroCos(double deg) {
+  return cos(deg * (M_PI / 180));
+}
+
+// Greenwich mean sidereal time, degrees
+double astroSiderealDeg(double days);
+
+// Right ascension and declination, degrees
+struct Equatorial {
+  double ra;
+  double dec;
+};
+
+Equatorial astroFromEcliptic(double days, double lonDeg, double latDeg);
+
+// Hour angle and altitude, degrees, of `eq` seen from `p`
+double astroHourAngle(const Equatorial &eq, const GeoPoint &p, double days);
+double astroAltitude(const Equatorial &eq, const GeoPoint &p, double days);
+
+// Apparent ecliptic longitude of the sun, degrees (good to 0.01)
+double astroSunLongitude(double days);
+
+// Something that changes sign at an event, e.g. altitude above the horizon
+typedef double (*AstroCurve)(void *ctx, double epoch);
+
+// First minute of `day` where `curve` crosses zero going up (rising > 0)
+// or down, or SAMPLE_NO_TIME if it does not. The curve is sampled hourly
+// and the crossing refined by bisection to a few seconds; jumps of more
+// than 180 (an angle wrapping round) are not crossings.
+uint16_t astroCrossing(AstroCurve curve, void *ctx, const LocalDay &day, int rising);
+
+#endif
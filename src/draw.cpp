@@ -2,11 +2,72 @@
 #include <TFT_eSPI.h>
 #include <SPI.h>
 #include <SD.h>
+#include <atomic>
+#include "freertos/semphr.h"
+#include "log.h"
+#include "draw.h"
+#include <PixelConvert.h>
+#include "imagecache.h"
 
-#define BUFFPIXEL 20
+// Rows read and converted per block
+#define BMP_BLOCK_ROWS 8
+// Row blocks in flight between the decode task and the display push
+#define DECODE_RING_SLOTS 3
+// SD reads and conversion run here; the Arduino loop, and so the display
+// push, runs on the other core
+#define DECODE_CORE 0
 
 extern TFT_eSPI tft;
 
+static bool dmaReady = false;
+
+struct BmpInfo {
+  uint32_t fileSize;
+  uint32_t imageOffset;
+  int32_t width;
+  int32_t height;
+  uint32_t rowSize;
+  bool bottomUp;
+};
+
+// Everything the decode task needs for one image
+struct DecodeJob {
+  fs::File *file;
+  bool raw;
+  BmpInfo bmp;
+  bool sequential;
+  bool flipped;
+  int32_t width;
+  int32_t height;
+  CachedImage *capture;
+  uint8_t *sdbuffer;
+  uint32_t bytesRead;
+  bool ok;
+};
+
+struct RowBlock {
+  uint16_t *pixels;
+  int rows; // 0 marks the end of the image
+};
+
+// Single-producer/single-consumer ring of row blocks: the decode task only
+// advances ringHead, the display side only advances ringTail. Each side
+// sleeps on its task notification when the ring is full or empty.
+static RowBlock ring[DECODE_RING_SLOTS];
+static std::atomic<uint32_t> ringHead(0);
+static std::atomic<uint32_t> ringTail(0);
+static TaskHandle_t producerTask = nullptr;
+static TaskHandle_t consumerTask = nullptr;
+static SemaphoreHandle_t jobReady = nullptr;
+static DecodeJob *currentJob = nullptr;
+static DecodeStats stats;
+
+static SpiStats spi;
+
+// Transparent color for keyed blits, held in the byte order pixels are pushed in
+static bool colorKeyed = false;
+static uint16_t colorKeyWire = 0;
+
 // Draw a BMP file from SD card to the TFT
 uint16_t read16(fs::File &f) {
   uint16_t result;
@@ -24,126 +85,647 @@ uint32_t read32(fs::File &f) {
   return result;
 }
 
-void drawBmp(const char *filename, int16_t x, int16_t y) {
-  Serial.print("Opening "); Serial.println(filename);
-  fs::File bmpFile = SD.open(filename);
-  if (!bmpFile) {
-    Serial.println("File not found!");
-    return;
-  } else{
-    Serial.println("File Found");
+static void decodeTask(void *);
+
+void drawInit() {
+  dmaReady = tft.initDMA();
+  LOG_INFO("TFT DMA %s", dmaReady ? "enabled" : "unavailable");
+  jobReady = xSemaphoreCreateBinary();
+  if (!jobReady || xTaskCreatePinnedToCore(decodeTask, "decode", 4096, nullptr, 1,
+                                           &producerTask, DECODE_CORE) != pdPASS) {
+    producerTask = nullptr;
+    LOG_ERROR("Could not start decode task");
   }
+}
+
+DecodeStats decodeStats() {
+  return stats;
+}
+
+SpiStats spiStats() {
+  return spi;
+}
+
+// Rough wire time for the traffic in `stats`, counting the 11 command and
+// parameter bytes (CASET, PASET, RAMWR) behind every address window
+uint32_t spiBusMicros(const SpiStats &stats) {
+  uint64_t bits = ((uint64_t)stats.bytes + (uint64_t)stats.windows * 11) * 8;
+  return (uint32_t)(bits * 1000000ULL / SPI_FREQUENCY);
+}
+
+void setColorKey(uint16_t color) {
+  colorKeyed = true;
+  colorKeyWire = (color >> 8) | (color << 8);
+}
 
-  uint32_t fileSize = bmpFile.size();
-  Serial.print("File size: "); Serial.println(fileSize);
+void clearColorKey() {
+  colorKeyed = false;
+}
+
+static bool readBmpHeader(fs::File &bmpFile, BmpInfo &info) {
+  info.fileSize = bmpFile.size();
+  LOG_DEBUG("File size: %u", info.fileSize);
 
   if (read16(bmpFile) != 0x4D42) {
-    Serial.println("Not a BMP!");
-    bmpFile.close();
-    return;
+    LOG_ERROR("Not a BMP!");
+    return false;
   } else {
-    Serial.println("BMP");
+    LOG_TRACE("BMP");
   }
 
   (void)read32(bmpFile); // file size 
   (void)read32(bmpFile); // reserved
-  uint32_t imageOffset = read32(bmpFile);
+  info.imageOffset = read32(bmpFile);
   (void)read32(bmpFile); // header size
   int32_t w = read32(bmpFile);
   int32_t h = read32(bmpFile);
-  if (read16(bmpFile) != 1) { bmpFile.close(); return; }
+  if (read16(bmpFile) != 1) return false;
   uint16_t depth = read16(bmpFile);
   uint32_t compression = read32(bmpFile);
 
-  Serial.printf("W=%d H=%d depth=%u comp=%u off=%u\n", w, h, depth, compression, imageOffset);
+  LOG_DEBUG("W=%d H=%d depth=%u off=%u", w, h, depth, info.imageOffset);
 
   if (depth != 24 || compression != 0) {
-    Serial.println("Unsupported BMP format (need 24-bit, no compression)");
-    bmpFile.close();
-    return;
+    LOG_ERROR("Unsupported BMP format (need 24-bit, no compression)");
+    return false;
   } else {
-    Serial.println("Supported BMP format");
+    LOG_TRACE("Supported BMP format");
   }
 
   if (w <= 0 || h == 0) {
-    Serial.println("Invalid dimensions");
-    bmpFile.close();
-    return;
+    LOG_ERROR("Invalid dimensions");
+    return false;
   } else {
-    Serial.println("Valid dimensions");
+    LOG_TRACE("Valid dimensions");
   }
 
-  bool flip = true;
-  if (h < 0) { h = -h; flip = false; }
+  info.bottomUp = true;
+  if (h < 0) { h = -h; info.bottomUp = false; }
+  info.width = w;
+  info.height = h;
+  info.rowSize = (w * 3 + 3) & ~3;
 
-  // Clip to screen bounds
-  if (x + w > tft.width() || y + h > tft.height()) {
-    Serial.println("Image exceeds screen bounds, aborting");
-    bmpFile.close();
-    return;
+  if (info.imageOffset >= info.fileSize) {
+    LOG_ERROR("Bad imageOffset");
+    return false;
   } else {
-    Serial.println("Image within screen bounds");
+    LOG_TRACE("Pass imageOffset");
   }
 
-  int rowSize = (w * 3 + 3) & ~3;
-  if (imageOffset >= fileSize) {
-    Serial.println("Bad imageOffset");
-    bmpFile.close();
-    return;
+  if (info.imageOffset + (uint32_t)(h - 1) * info.rowSize + w * 3 > info.fileSize) {
+    LOG_ERROR("Pixel data truncated, file size %u", info.fileSize);
+    return false;
+  }
+  return true;
+}
+
+// Display writes in this file go through these so spiStats() sees all of
+// the traffic
+static void busBegin() {
+  tft.startWrite();
+  spi.transactions++;
+}
+
+static void busEnd() {
+  tft.endWrite();
+}
+
+static void busWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+  tft.setAddrWindow(x, y, w, h);
+  spi.windows++;
+}
+
+// Send pixels into the open address window. With DMA the call returns as
+// soon as the transfer is queued; pushPixelsDMA() waits for the previous
+// block first.
+static void pushBlock(uint16_t *pixels, uint32_t count, bool dma) {
+  if (dma) {
+    tft.pushPixelsDMA(pixels, count);
   } else {
-    Serial.println("Pass imageOffset");
+    tft.pushPixels(pixels, count);
   }
+  spi.bytes += count * sizeof(uint16_t);
+}
 
-  const int bufPixels = BUFFPIXEL;
-  uint8_t sdbuffer[3 * bufPixels];
-  uint16_t lcdbuffer[bufPixels];
+static void logSpiStats(const SpiStats &before) {
+  SpiStats delta = { spi.bytes - before.bytes, spi.windows - before.windows,
+                     spi.transactions - before.transactions };
+  LOG_INFO("SPI %u bytes, %u windows, %u transactions, ~%u us on the bus", delta.bytes,
+           delta.windows, delta.transactions, spiBusMicros(delta));
+}
 
-  for (int row = 0; row < h; ++row) {
-    // Allow background tasks / watchdog
-    yield();
+// Push only the runs of a row that differ from the color key, each through
+// its own one-row window. Must be called inside a write transaction.
+static void pushOpaqueSpans(const uint16_t *line, int32_t width, int32_t x, int32_t y) {
+  int32_t i = 0;
+  while (i < width) {
+    while (i < width && line[i] == colorKeyWire) ++i;
+    int32_t start = i;
+    while (i < width && line[i] != colorKeyWire) ++i;
+    if (i > start) {
+      busWindow(x + start, y, i - start, 1);
+      pushBlock((uint16_t *)line + start, i - start, false);
+    }
+  }
+}
 
-    uint32_t rowPos = imageOffset + (flip ? (uint32_t)(h - 1 - row) * rowSize
-                                         : (uint32_t)row * rowSize);
-    if (rowPos >= fileSize) {
-      Serial.printf("Row pos %u out of range, file size %u\n", rowPos, fileSize);
-      break;
-    } else {
-      Serial.println("Row pos in range");
+#if defined(ST7796_DRIVER)
+// MADCTL value TFT_eSPI's ST7796 driver programs for each rotation
+static uint8_t madctlForRotation(uint8_t rotation) {
+  switch (rotation) {
+    case 0: return TFT_MAD_MX | TFT_MAD_COLOR_ORDER;
+    case 1: return TFT_MAD_MV | TFT_MAD_COLOR_ORDER;
+    case 2: return TFT_MAD_MY | TFT_MAD_COLOR_ORDER;
+    default: return TFT_MAD_MX | TFT_MAD_MY | TFT_MAD_MV | TFT_MAD_COLOR_ORDER;
+  }
+}
+
+// Mirror the panel's row order so a bottom-up BMP fills the window in file
+// order. With MV set the controller's column axis runs down the screen, so
+// MX is the bit that flips it. restorePanelRows() puts the panel back.
+static bool flipPanelRows() {
+  uint8_t rotation = tft.getRotation();
+  if (rotation > 3) return false;
+  uint8_t madctl = madctlForRotation(rotation);
+  madctl ^= (madctl & TFT_MAD_MV) ? TFT_MAD_MX : TFT_MAD_MY;
+  // Outside startWrite() the command and its parameter each take the bus
+  tft.writecommand(TFT_MADCTL);
+  tft.writedata(madctl);
+  spi.transactions += 2;
+  return true;
+}
+#else
+// The row mirroring is worked out for the ST7796's MADCTL; with another
+// controller bottom-up files are read by seeking to each row instead
+static bool flipPanelRows() {
+  return false;
+}
+#endif
+
+static void restorePanelRows(uint8_t rotation) {
+  tft.setRotation(rotation);
+  spi.transactions++;
+}
+
+// Push a cached image in one go. DMA cannot read PSRAM, so those entries
+// go through the blocking path.
+static void blitCached(const CachedImage &img, int16_t x, int16_t y) {
+  bool swap = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+  busBegin();
+  if (colorKeyed) {
+    for (uint16_t r = 0; r < img.height; ++r) {
+      pushOpaqueSpans(img.pixels + r * img.width, img.width, x, y + r);
     }
+  } else {
+    bool dma = dmaReady && !img.inPsram;
+    busWindow(x, y, img.width, img.height);
+    pushBlock(img.pixels, (uint32_t)img.width * img.height, dma);
+    if (dma) tft.dmaWait();
+  }
+  busEnd();
+  tft.setSwapBytes(swap);
+}
 
+// Serve a repeat draw from the image cache; false on a miss
+static bool drawFromCache(fs::File &file, const char *filename, int16_t x, int16_t y, uint32_t startTime) {
+  const CachedImage *cached = imageCacheFind(filename, file.size(), file.getLastWrite());
+  if (!cached) return false;
+  SpiStats before = spi;
+  file.close();
+  if (x + cached->width > tft.width() || y + cached->height > tft.height()) {
+    LOG_ERROR("Image exceeds screen bounds, aborting");
+    return true;
+  }
+  blitCached(*cached, x, y);
+  LOG_INFO("%s: cache hit in %lu ms", filename, millis() - startTime);
+  logSpiStats(before);
+  return true;
+}
+
+// Read the next `rows` file rows (padding included) into sdbuffer, zero-filling
+// anything the card did not return. Sequential reads are one contiguous read;
+// otherwise each row is seeked to, bottom-up.
+static bool readBmpRows(fs::File &bmpFile, const BmpInfo &info, int row, int rows,
+                        bool sequential, uint8_t *sdbuffer) {
+  if (sequential) {
+    size_t bytesNeeded = rows * info.rowSize;
+    int bytesRead = bmpFile.read(sdbuffer, bytesNeeded);
+    if (bytesRead <= 0) {
+      LOG_ERROR("Read error at row %d (requested %u got %d)", row, bytesNeeded, bytesRead);
+      return false;
+    } else if ((size_t)bytesRead < bytesNeeded) {
+      // The final row's padding is sometimes left out
+      memset(sdbuffer + bytesRead, 0, bytesNeeded - bytesRead);
+      LOG_TRACE("Partial read %d/%u", bytesRead, bytesNeeded);
+    }
+    return true;
+  }
+
+  for (int r = 0; r < rows; ++r) {
+    uint32_t rowPos = info.imageOffset + (uint32_t)(info.height - 1 - row - r) * info.rowSize;
     if (!bmpFile.seek(rowPos)) {
-      Serial.printf("seek failed to %u\n", rowPos);
-      break;
+      LOG_ERROR("seek failed to %u", rowPos);
+      return false;
     } else {
-      Serial.println("Seek passed");
+      LOG_TRACE("Seek passed");
     }
 
-    for (int col = 0; col < w; col += bufPixels) {
-      int block = min(bufPixels, w - col);
-      size_t bytesNeeded = block * 3;
-      int bytesRead = bmpFile.read(sdbuffer, bytesNeeded);
-      if (bytesRead <= 0) {
-        Serial.printf("Read error at row %d col %d (requested %u got %d)\n", row, col, bytesNeeded, bytesRead);
-        memset(sdbuffer, 0, bytesNeeded);
-      } else if ((size_t)bytesRead < bytesNeeded) {
-        memset(sdbuffer + bytesRead, 0, bytesNeeded - bytesRead);
-        Serial.printf("Partial read %d/%u\n", bytesRead, bytesNeeded);
-      }
+    uint8_t *dst = sdbuffer + r * info.rowSize;
+    size_t bytesNeeded = info.width * 3;
+    int bytesRead = bmpFile.read(dst, bytesNeeded);
+    if (bytesRead <= 0) {
+      LOG_ERROR("Read error at row %d (requested %u got %d)", row + r, bytesNeeded, bytesRead);
+      memset(dst, 0, bytesNeeded);
+    } else if ((size_t)bytesRead < bytesNeeded) {
+      memset(dst + bytesRead, 0, bytesNeeded - bytesRead);
+      LOG_WARN("Partial read %d/%u", bytesRead, bytesNeeded);
+    }
+  }
+  return true;
+}
 
-      for (int i = 0; i < block; ++i) {
-        uint8_t b = sdbuffer[i * 3 + 0];
-        uint8_t g = sdbuffer[i * 3 + 1];
-        uint8_t r = sdbuffer[i * 3 + 2];
-        lcdbuffer[i] = tft.color565(r, g, b);
+// Fill one ring slot with the next `rows` rows of the image
+static bool decodeBlock(DecodeJob &job, int row, int rows, uint16_t *out) {
+  int32_t w = job.width;
+  if (job.raw) {
+    size_t bytesNeeded = rows * w * 2;
+    int got = job.file->read((uint8_t *)out, bytesNeeded);
+    if (got <= 0) {
+      LOG_ERROR("Read error at row %d (requested %u got %d)", row, bytesNeeded, got);
+      return false;
+    }
+    job.bytesRead += got;
+    if ((size_t)got < bytesNeeded) {
+      memset((uint8_t *)out + got, 0, bytesNeeded - got);
+      LOG_WARN("Partial read %d/%u", got, bytesNeeded);
+    }
+    if (job.capture) memcpy(job.capture->pixels + row * w, out, bytesNeeded);
+    return true;
+  }
+
+  if (!readBmpRows(*job.file, job.bmp, row, rows, job.sequential, job.sdbuffer)) return false;
+  job.bytesRead += rows * job.bmp.rowSize;
+  for (int r = 0; r < rows; ++r) {
+    convertBgr888ToRgb565(job.sdbuffer + r * job.bmp.rowSize, out + r * w, w);
+    if (job.capture) {
+      // The cache keeps rows top-down whatever order they were pushed in
+      int imageRow = job.flipped ? job.height - 1 - (row + r) : row + r;
+      memcpy(job.capture->pixels + imageRow * w, out + r * w, w * sizeof(uint16_t));
+    }
+  }
+  return true;
+}
+
+// Producer: waits for a job, then reads and converts blocks into the ring
+// until the image is done, finishing with an end marker.
+static void decodeTask(void *) {
+  uint32_t head = 0;
+  for (;;) {
+    xSemaphoreTake(jobReady, portMAX_DELAY);
+    DecodeJob &job = *currentJob;
+    int row = 0;
+    bool ok = true;
+    while (ok) {
+      while (head - ringTail.load(std::memory_order_acquire) == DECODE_RING_SLOTS) {
+        stats.producerStalls++;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      }
+      RowBlock &block = ring[head % DECODE_RING_SLOTS];
+      if (row < job.height) {
+        block.rows = min(BMP_BLOCK_ROWS, job.height - row);
+        ok = decodeBlock(job, row, block.rows, block.pixels);
+        row += block.rows;
+        if (!ok) block.rows = 0;
+      } else {
+        block.rows = 0;
+      }
+      if (block.rows == 0) {
+        job.ok = ok;
+        ok = false;
       }
+      ringHead.store(++head, std::memory_order_release);
+      xTaskNotifyGive(consumerTask);
+    }
+  }
+}
 
-      // Acquire display SPI only for the actual pushImage call
-      tft.startWrite();
-      tft.pushImage(x + col, y + row, block, 1, lcdbuffer);
-      tft.endWrite();
+// Consumer: push blocks into the open address window as they arrive. A slot
+// goes back to the producer once the block after it has been queued, since
+// pushPixelsDMA() has waited for it by then.
+static void pushBlocks(int32_t width, int16_t x, int16_t winY) {
+  uint32_t tail = ringTail.load(std::memory_order_relaxed);
+  uint32_t next = tail;
+  int32_t row = 0;
+  for (;;) {
+    while (ringHead.load(std::memory_order_acquire) == next) {
+      stats.consumerStalls++;
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
+    RowBlock &block = ring[next % DECODE_RING_SLOTS];
+    ++next;
+    if (block.rows == 0) break;
+
+#if SD_SHARES_TFT_SPI
+    busBegin();
+#endif
+    if (colorKeyed) {
+      for (int r = 0; r < block.rows; ++r) {
+        pushOpaqueSpans(block.pixels + r * width, width, x, winY + row + r);
+      }
+    } else {
+      pushBlock(block.pixels, block.rows * width, dmaReady);
+    }
+#if SD_SHARES_TFT_SPI
+    if (dmaReady) tft.dmaWait();
+    busEnd();
+#endif
+    row += block.rows;
+    if (next - tail > 1) {
+      ringTail.store(++tail, std::memory_order_release);
+      xTaskNotifyGive(producerTask);
+    }
+  }
+  if (dmaReady) tft.dmaWait();
+  ringTail.store(next, std::memory_order_release);
+}
+
+// Run one image through the decode task into the window at (x, winY).
+// Returns once the last row is on the panel.
+static bool runDecode(DecodeJob &job, int16_t x, int16_t winY) {
+  if (!producerTask) {
+    LOG_ERROR("Decode task not running");
+    return false;
+  }
+  int i = 0;
+  for (; i < DECODE_RING_SLOTS; ++i) {
+    ring[i].pixels = (uint16_t *)heap_caps_malloc(job.width * BMP_BLOCK_ROWS * sizeof(uint16_t), MALLOC_CAP_DMA);
+    if (!ring[i].pixels) break;
+  }
+  if (i < DECODE_RING_SLOTS) {
+    LOG_ERROR("Out of memory for row blocks");
+    while (i--) heap_caps_free(ring[i].pixels);
+    return false;
+  }
+
+  // One address window for the whole image; every block continues the same
+  // memory write, so no per-chunk window setup on the bus. Pixels arrive in
+  // wire order.
+  bool swap = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+  busBegin();
+  busWindow(x, winY, job.width, job.height);
+#if SD_SHARES_TFT_SPI
+  busEnd();
+#endif
+
+  job.ok = false;
+  currentJob = &job;
+  consumerTask = xTaskGetCurrentTaskHandle();
+  xSemaphoreGive(jobReady);
+  pushBlocks(job.width, x, winY);
+
+#if !SD_SHARES_TFT_SPI
+  busEnd();
+#endif
+  tft.setSwapBytes(swap);
+  for (i = 0; i < DECODE_RING_SLOTS; ++i) heap_caps_free(ring[i].pixels);
+  return job.ok;
+}
+
+static void logDrawStats(const SpiStats &before) {
+  logSpiStats(before);
+  ImageCacheStats cache = imageCacheStats();
+  LOG_INFO("Image cache hits=%u misses=%u evictions=%u held=%u", cache.hits, cache.misses,
+           cache.evictions, cache.bytesHeld);
+  LOG_INFO("Decode stalls producer=%u consumer=%u", stats.producerStalls, stats.consumerStalls);
+}
+
+void drawBmp(const char *filename, int16_t x, int16_t y) {
+  uint32_t startTime = millis();
+  LOG_DEBUG("Opening %s", filename);
+  fs::File bmpFile = SD.open(filename);
+  if (!bmpFile) {
+    LOG_ERROR("File not found: %s", filename);
+    return;
+  } else{
+    LOG_TRACE("File Found");
   }
+  if (drawFromCache(bmpFile, filename, x, y, startTime)) return;
+  SpiStats before = spi;
 
+  DecodeJob job = {};
+  job.file = &bmpFile;
+  if (!readBmpHeader(bmpFile, job.bmp)) {
+    bmpFile.close();
+    return;
+  }
+  int32_t w = job.width = job.bmp.width;
+  int32_t h = job.height = job.bmp.height;
+
+  // Clip to screen bounds
+  if (x + w > tft.width() || y + h > tft.height()) {
+    LOG_ERROR("Image exceeds screen bounds, aborting");
+    bmpFile.close();
+    return;
+  } else {
+    LOG_TRACE("Image within screen bounds");
+  }
+
+  job.sdbuffer = (uint8_t *)malloc(job.bmp.rowSize * BMP_BLOCK_ROWS);
+  if (!job.sdbuffer) {
+    LOG_ERROR("Out of memory for BMP buffers");
+    bmpFile.close();
+    return;
+  }
+  job.capture = imageCacheReserve(filename, job.bmp.fileSize, bmpFile.getLastWrite(), w, h);
+
+  // Bottom-up files are drawn into a vertically mirrored window so the whole
+  // pixel array is one forward read; the SD card never seeks backwards.
+  uint8_t rotation = tft.getRotation();
+  job.flipped = job.bmp.bottomUp && flipPanelRows();
+  job.sequential = job.flipped || !job.bmp.bottomUp;
+  int16_t winY = job.flipped ? tft.height() - y - h : y;
+  if (job.sequential) bmpFile.seek(job.bmp.imageOffset);
+
+  bool ok = runDecode(job, x, winY);
+  if (job.flipped) restorePanelRows(rotation);
+
+  if (ok) imageCacheCommit(job.capture);
+  else imageCacheAbort(job.capture);
+
+  free(job.sdbuffer);
   bmpFile.close();
-  Serial.println("BMP draw complete");
-}
\ No newline at end of file
+  LOG_INFO("BMP %s: %u bytes read in %lu ms", filename, job.bytesRead, millis() - startTime);
+  logDrawStats(before);
+}
+
+// Pixels follow the header and the sprite index, if any
+static uint32_t rawDataOffset(const RawHeader &header) {
+  return sizeof(RawHeader) + (uint32_t)header.spriteCount * sizeof(SpriteEntry);
+}
+
+// Native asset: RawHeader, then big-endian RGB565 rows, top-down, unpadded.
+// The pixel data is already in wire order, so it goes from the card to the
+// panel without touching individual pixels.
+static bool readRawHeader(fs::File &rawFile, RawHeader &header) {
+  if (rawFile.read((uint8_t *)&header, sizeof header) != sizeof header) {
+    LOG_ERROR("Short raw header");
+    return false;
+  }
+  if (memcmp(header.magic, RAW_MAGIC, sizeof header.magic) != 0) {
+    LOG_ERROR("Not a raw RGB565 asset");
+    return false;
+  }
+  if (header.format != RAW_FORMAT_RGB565_BE) {
+    LOG_ERROR("Unsupported raw format %u", header.format);
+    return false;
+  }
+  if (header.width == 0 || header.height == 0 ||
+      rawFile.size() < rawDataOffset(header) + (uint32_t)header.width * header.height * 2) {
+    LOG_ERROR("Invalid raw dimensions %ux%u", header.width, header.height);
+    return false;
+  }
+  return true;
+}
+
+void drawRaw(const char *filename, int16_t x, int16_t y) {
+  uint32_t startTime = millis();
+  LOG_DEBUG("Opening %s", filename);
+  fs::File rawFile = SD.open(filename);
+  if (!rawFile) {
+    LOG_ERROR("File not found: %s", filename);
+    return;
+  }
+  if (drawFromCache(rawFile, filename, x, y, startTime)) return;
+  SpiStats before = spi;
+
+  RawHeader header;
+  if (!readRawHeader(rawFile, header)) {
+    rawFile.close();
+    return;
+  }
+  DecodeJob job = {};
+  job.file = &rawFile;
+  job.raw = true;
+  int32_t w = job.width = header.width;
+  int32_t h = job.height = header.height;
+  job.bytesRead = sizeof header;
+  if (header.spriteCount) rawFile.seek(rawDataOffset(header));
+
+  if (x + w > tft.width() || y + h > tft.height()) {
+    LOG_ERROR("Image exceeds screen bounds, aborting");
+    rawFile.close();
+    return;
+  }
+  job.capture = imageCacheReserve(filename, rawFile.size(), rawFile.getLastWrite(), w, h);
+
+  if (runDecode(job, x, y)) imageCacheCommit(job.capture);
+  else imageCacheAbort(job.capture);
+
+  rawFile.close();
+  LOG_INFO("RAW %s: %u bytes read in %lu ms", filename, job.bytesRead, millis() - startTime);
+  logDrawStats(before);
+}
+
+void drawImage(const char *filename, int16_t x, int16_t y) {
+  // Prefer a pre-converted sibling ("/fish.bmp" -> "/fish.565") when present
+  const char *ext = strrchr(filename, '.');
+  if (ext && strcmp(ext, ".bmp") == 0) {
+    char rawName[64];
+    size_t stem = ext - filename;
+    if (stem + sizeof RAW_EXTENSION <= sizeof rawName) {
+      memcpy(rawName, filename, stem);
+      strcpy(rawName + stem, RAW_EXTENSION);
+      if (SD.exists(rawName)) {
+        drawRaw(rawName, x, y);
+        return;
+      }
+    }
+  }
+  drawBmp(filename, x, y);
+}
+
+bool loadAtlas(SpriteAtlas &atlas, const char *filename) {
+  atlas.sprites = nullptr;
+  atlas.file = SD.open(filename);
+  if (!atlas.file) {
+    LOG_ERROR("File not found: %s", filename);
+    return false;
+  }
+  if (!readRawHeader(atlas.file, atlas.header) || atlas.header.spriteCount == 0) {
+    LOG_ERROR("%s is not a sprite atlas", filename);
+    atlas.file.close();
+    return false;
+  }
+
+  size_t indexBytes = atlas.header.spriteCount * sizeof(SpriteEntry);
+  atlas.sprites = (SpriteEntry *)malloc(indexBytes);
+  if (!atlas.sprites || atlas.file.read((uint8_t *)atlas.sprites, indexBytes) != indexBytes) {
+    LOG_ERROR("Could not load sprite index of %s", filename);
+    closeAtlas(atlas);
+    return false;
+  }
+  atlas.dataOffset = rawDataOffset(atlas.header);
+  LOG_DEBUG("Atlas %s: %u sprites", filename, atlas.header.spriteCount);
+  return true;
+}
+
+void closeAtlas(SpriteAtlas &atlas) {
+  free(atlas.sprites);
+  atlas.sprites = nullptr;
+  if (atlas.file) atlas.file.close();
+}
+
+static const SpriteEntry *findSprite(const SpriteAtlas &atlas, const char *name) {
+  for (uint16_t i = 0; i < atlas.header.spriteCount; ++i) {
+    if (strncmp(atlas.sprites[i].name, name, sizeof atlas.sprites[i].name) == 0) return &atlas.sprites[i];
+  }
+  return nullptr;
+}
+
+// Only the sprite's own rows and columns are read: one seek per row when it
+// is narrower than the atlas, a single contiguous read otherwise.
+bool drawSprite(SpriteAtlas &atlas, const char *name, int16_t x, int16_t y) {
+  if (!atlas.sprites) return false;
+  const SpriteEntry *sprite = findSprite(atlas, name);
+  if (!sprite) {
+    LOG_ERROR("No sprite %s", name);
+    return false;
+  }
+  if (sprite->x + sprite->w > atlas.header.width || sprite->y + sprite->h > atlas.header.height ||
+      x + sprite->w > tft.width() || y + sprite->h > tft.height()) {
+    LOG_ERROR("Sprite %s out of bounds", name);
+    return false;
+  }
+
+  size_t rowBytes = sprite->w * sizeof(uint16_t);
+  uint16_t *line = (uint16_t *)malloc(rowBytes);
+  if (!line) {
+    LOG_ERROR("Out of memory for sprite row");
+    return false;
+  }
+
+  bool swap = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+  busBegin();
+  busWindow(x, y, sprite->w, sprite->h);
+  busEnd();
+
+  bool ok = true;
+  for (uint16_t r = 0; r < sprite->h; ++r) {
+    uint32_t pos = atlas.dataOffset +
+                   ((uint32_t)(sprite->y + r) * atlas.header.width + sprite->x) * sizeof(uint16_t);
+    if (atlas.file.position() != pos) atlas.file.seek(pos);
+    ok = atlas.file.read((uint8_t *)line, rowBytes) == rowBytes;
+    if (!ok) break;
+    busBegin();
+    if (colorKeyed) pushOpaqueSpans(line, sprite->w, x, y + r);
+    else pushBlock(line, sprite->w, false);
+    busEnd();
+  }
+  tft.setSwapBytes(swap);
+  free(line);
+  if (!ok) LOG_ERROR("Read error in sprite %s", name);
+  return ok;
+}
@@ -4,9 +4,80 @@
 #include <TFT_eSPI.h>
 #include <Arduino.h>
 
+#define RAW_MAGIC "R565"
+#define RAW_EXTENSION ".565"
+#define RAW_FORMAT_RGB565_BE 0
+
+// On this board the SD card sits on the same SPI bus as the display, so
+// the display only holds the bus while a block is on the wire and waits
+// for each DMA push before handing it back. SD reads and pushes therefore
+// take turns; only the RGB565 conversion overlaps a transfer. Build with
+// -DSD_SHARES_TFT_SPI=0 when the card is on its own bus to keep one
+// transaction open for the whole image and overlap the reads as well.
+#ifndef SD_SHARES_TFT_SPI
+#define SD_SHARES_TFT_SPI 1
+#endif
+
+// Header of the native image asset written by tools/img2raw.py. Multi-byte
+// fields are little-endian like the BMP header. A sprite atlas is the same
+// format with spriteCount index entries between the header and the pixels.
+struct __attribute__((packed)) RawHeader {
+  char magic[4];
+  uint16_t width;
+  uint16_t height;
+  uint8_t format;
+  uint8_t flags;
+  uint16_t spriteCount;
+};
+
+struct __attribute__((packed)) SpriteEntry {
+  char name[12]; // NUL-padded, not terminated at full length
+  uint16_t x;
+  uint16_t y;
+  uint16_t w;
+  uint16_t h;
+};
+
+// An atlas stays open with its index in RAM so each sprite costs only the
+// reads for its own pixels.
+struct SpriteAtlas {
+  fs::File file;
+  RawHeader header;
+  uint32_t dataOffset;
+  SpriteEntry *sprites;
+};
+
+// Times either side of the decode ring had to wait on the other: producer
+// stalls mean the panel is the bottleneck, consumer stalls the SD card.
+struct DecodeStats {
+  uint32_t producerStalls;
+  uint32_t consumerStalls;
+};
+
+// Display traffic generated by the draw functions since boot
+struct SpiStats {
+  uint32_t bytes;        // pixel bytes pushed
+  uint32_t windows;      // address window changes
+  uint32_t transactions; // bus acquisitions
+};
+
 extern TFT_eSPI tft;
+void drawInit();
+DecodeStats decodeStats();
+SpiStats spiStats();
+// Estimated wire time for the traffic at SPI_FREQUENCY
+uint32_t spiBusMicros(const SpiStats &stats);
+// While a color key is set, pixels of that color are skipped by every draw
+// call and only opaque runs are sent to the panel
+void setColorKey(uint16_t color);
+void clearColorKey();
 void drawBmp(const char *filename, int16_t x, int16_t y);
+void drawRaw(const char *filename, int16_t x, int16_t y);
+void drawImage(const char *filename, int16_t x, int16_t y);
+bool loadAtlas(SpriteAtlas &atlas, const char *filename);
+void closeAtlas(SpriteAtlas &atlas);
+bool drawSprite(SpriteAtlas &atlas, const char *name, int16_t x, int16_t y);
 uint16_t read16(fs::File &f);
 uint32_t read32(fs::File &f);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,111 @@
+#include <Arduino.h>
+#include <atomic>
+#include "freertos/semphr.h"
+#include "fetchpool.h"
+#include "weatherclient.h"
+#include "log.h"
+
+// Parked value of FetchJob::next between batches; far enough past any count
+// that stray increments from a late worker never wrap back into range
+#define FETCH_IDLE 0x80000000UL
+
+// The batch being fetched. Workers claim locations by bumping `next`, and
+// publish each finished one as a bit in `done`, so out[] and codes[] need
+// no lock: every slot has exactly one writer.
+struct FetchJob {
+  const String *locations;
+  uint8_t count;
+  WeatherSample *out;
+  HourlyForecast *hourly;
+  int *codes;
+  std::atomic<uint32_t> next;
+  std::atomic<uint32_t> done;
+};
+
+static WeatherClient *clients[FETCH_WORKERS];
+static TaskHandle_t workers[FETCH_WORKERS];
+static uint8_t workerCount = 0;
+static SemaphoreHandle_t progress = nullptr;
+static FetchJob job;
+
+static void fetchTask(void *arg) {
+  WeatherClient &client = *(WeatherClient *)arg;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    uint32_t i;
+    while ((i = job.next.fetch_add(1, std::memory_order_acquire)) < job.count) {
+      if (job.done.load(std::memory_order_relaxed) & (1UL << i)) continue;
+      job.codes[i] = client.fetch(job.locations[i], job.out[i],
+                                  job.hourly ? &job.hourly[i] : nullptr);
+      job.done.fetch_or(1UL << i, std::memory_order_release);
+      xSemaphoreGive(progress);
+    }
+  }
+}
+
+void fetchPoolInit(const char *host, uint16_t port, const char *apiKey) {
+  job.next.store(FETCH_IDLE);
+  progress = xSemaphoreCreateBinary();
+  for (uint8_t i = 0; i < FETCH_WORKERS; ++i) {
+    clients[i] = new WeatherClient(host, port, apiKey);
+  }
+  if (!progress) {
+    LOG_ERROR("Could not start fetch workers");
+    return;
+  }
+  for (uint8_t i = 0; i < FETCH_WORKERS; ++i) {
+    if (xTaskCreate(fetchTask, "fetch", FETCH_WORKER_STACK, clients[i], 1, &workers[i]) != pdPASS) {
+      break;
+    }
+    workerCount++;
+  }
+  LOG_INFO("%d fetch workers", (int)workerCount);
+}
+
+void fetchWeatherAll(const String *locations, uint8_t count, WeatherSample *out,
+                     HourlyForecast *hourly, int *codes,
+                     uint32_t skip, FetchReady onReady, void *ctx) {
+  count = min(count, (uint8_t)32);
+  uint32_t all = count == 32 ? UINT32_MAX : (1UL << count) - 1;
+  uint32_t want = all & ~skip;
+  uint32_t found = skip;
+  // Bulk only pays off for two or more requests
+  if (WEATHER_BULK && (want & (want - 1))) {
+    uint32_t got = clients[0]->fetchBulk(locations, count, want, out, hourly);
+    for (uint8_t i = 0; i < count; ++i) {
+      if (got & (1UL << i)) codes[i] = 200;
+    }
+    found |= got;
+  }
+
+  if (workerCount == 0) {
+    for (uint8_t i = 0; i < count; ++i) {
+      if (!(found & (1UL << i))) {
+        codes[i] = clients[0]->fetch(locations[i], out[i], hourly ? &hourly[i] : nullptr);
+      }
+      if (onReady) onReady(i, ctx);
+    }
+    return;
+  }
+
+  // `next` sits at FETCH_IDLE between batches, so a worker that wakes late
+  // cannot claim anything until it is reset here
+  job.locations = locations;
+  job.count = count;
+  job.out = out;
+  job.hourly = hourly;
+  job.codes = codes;
+  job.done.store(found, std::memory_order_relaxed);
+  job.next.store(0, std::memory_order_release);
+  if (found != all) {
+    for (uint8_t w = 0; w < workerCount; ++w) xTaskNotifyGive(workers[w]);
+  }
+
+  for (uint8_t i = 0; i < count; ++i) {
+    while (!(job.done.load(std::memory_order_acquire) & (1UL << i))) {
+      xSemaphoreTake(progress, portMAX_DELAY);
+    }
+    if (onReady) onReady(i, ctx);
+  }
+  job.next.store(FETCH_IDLE, std::memory_order_relaxed);
+}
@@ -0,0 +1,32 @@
+#ifndef FETCHPOOL_H
+#define FETCHPOOL_H
+
+#include <Arduino.h>
+#include "weathersample.h"
+#include "forecast.h"
+
+// Requests in flight at once, each on its own connection and task
+#ifndef FETCH_WORKERS
+#define FETCH_WORKERS 3
+#endif
+#define FETCH_WORKER_STACK 8192
+
+// Called on the fetching task as each location's result becomes final, in
+// configured order
+typedef void (*FetchReady)(uint8_t index, void *ctx);
+
+// Starts the worker tasks. Until it succeeds fetchWeatherAll() runs
+// everything on the calling task.
+void fetchPoolInit(const char *host, uint16_t port, const char *apiKey);
+
+// Tries one bulk request first (see WEATHER_BULK), then fetches whatever it
+// did not return with up to FETCH_WORKERS requests at a time. codes[i] is
+// the status WeatherClient::fetch() gave for out[i], 200 for bulk results.
+// hourly[i] gets the location's forecast hours unless hourly is null.
+// Locations with a bit set in `skip` are left alone (out[i], hourly[i] and
+// codes[i] untouched) but still passed to onReady in turn.
+void fetchWeatherAll(const String *locations, uint8_t count, WeatherSample *out,
+                     HourlyForecast *hourly, int *codes,
+                     uint32_t skip, FetchReady onReady, void *ctx);
+
+#endif
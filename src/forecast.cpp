@@ -0,0 +1,48 @@
+#include <Arduino.h>
+#include "forecast.h"
+
+void forecastClear(HourlyForecast &f) {
+  f.startEpoch = 0;
+  f.hours = 0;
+  for (uint8_t i = 0; i < FORECAST_HOURS; ++i) {
+    f.tempDeciF[i] = SAMPLE_NO_TEMP;
+    f.pressureCentiIn[i] = SAMPLE_NO_PRESSURE;
+    f.windDeciMph[i] = SAMPLE_NO_WIND;
+    f.cloud[i] = SAMPLE_NO_PERCENT;
+    f.rainChance[i] = SAMPLE_NO_PERCENT;
+    f.solunar[i] = SAMPLE_NO_PERCENT;
+  }
+}
+
+int forecastSlot(const HourlyForecast &f, uint32_t epoch) {
+  if (f.hours == 0 || epoch < f.startEpoch) return -1;
+  uint32_t slot = (epoch - f.startEpoch) / 3600;
+  return slot < f.hours ? (int)slot : -1;
+}
+
+int bestWindow(const uint8_t *scores, uint8_t hours, uint8_t from, uint8_t window,
+               uint16_t &total) {
+  if (window == 0 || from + window > hours) return -1;
+  uint16_t sum = 0;
+  for (uint8_t i = from; i < from + window; ++i) sum += scores[i];
+  int best = from;
+  total = sum;
+  for (uint8_t i = from + window; i < hours; ++i) {
+    sum += scores[i] - scores[i - window];
+    // Strictly greater keeps the earliest of equal windows
+    if (sum > total) {
+      total = sum;
+      best = i - window + 1;
+    }
+  }
+  return best;
+}
+
+void slotLabel(const HourlyForecast &f, int slot, char out[12]) {
+  static const char *const days[] = { "Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed" };
+  // startEpoch is local midnight; half a day either way lands inside the
+  // same local date for any UTC offset, and 1 Jan 1970 was a Thursday
+  uint32_t day = (f.startEpoch + 43200UL) / 86400UL + slot / 24;
+  int hour = slot % 24;
+  snprintf(out, 12, "%s %d%s", days[day % 7], hour % 12 ? hour % 12 : 12, hour < 12 ? "AM" : "PM");
+}
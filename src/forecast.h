@@ -0,0 +1,41 @@
+#ifndef FORECAST_H
+#define FORECAST_H
+
+#include <Arduino.h>
+#include "weathersample.h"
+
+#define FORECAST_DAYS 3
+#define FORECAST_HOURS (FORECAST_DAYS * 24)
+
+// Hourly forecast for one location as struct-of-arrays, quantized like
+// WeatherSample (missing hours hold the SAMPLE_NO_* sentinels), so a
+// scoring pass streams one factor at a time. 656 bytes per location, three
+// of them padding: a dozen locations take under 8 KB of internal RAM.
+struct HourlyForecast {
+  uint32_t startEpoch; // time_epoch of slot 0, local midnight today
+  uint8_t hours;       // slots filled from the response
+  int16_t tempDeciF[FORECAST_HOURS];
+  int16_t pressureCentiIn[FORECAST_HOURS];
+  int16_t windDeciMph[FORECAST_HOURS];
+  int8_t cloud[FORECAST_HOURS];
+  int8_t rainChance[FORECAST_HOURS];
+  int8_t solunar[FORECAST_HOURS]; // 0-100 activity, filled locally, not parsed
+};
+
+static_assert(sizeof(HourlyForecast) == 656, "update the size in the comment above");
+
+void forecastClear(HourlyForecast &f);
+
+// Slot holding `epoch`, or -1 outside the forecast
+int forecastSlot(const HourlyForecast &f, uint32_t epoch);
+
+// Best run of `window` consecutive hourly scores among slots [from, hours):
+// the start slot of the highest sum, found with one sliding-sum pass, or -1
+// if fewer than `window` slots remain. `total` gets the winning sum.
+int bestWindow(const uint8_t *scores, uint8_t hours, uint8_t from, uint8_t window,
+               uint16_t &total);
+
+// "Tue 6AM" style label for a slot
+void slotLabel(const HourlyForecast &f, int slot, char out[12]);
+
+#endif
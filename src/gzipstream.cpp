@@ -0,0 +1,190 @@
+#include <Arduino.h>
+#include <atomic>
+#include "gzipstream.h"
+
+#define GZIP_ID1 0x1f
+#define GZIP_ID2 0x8b
+#define GZIP_DEFLATE 8
+#define GZIP_FHCRC 0x02
+#define GZIP_FEXTRA 0x04
+#define GZIP_FNAME 0x08
+#define GZIP_FCOMMENT 0x10
+
+bool GzipStream::begin() {
+  if (decomp) return true;
+  decomp = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+  window = (uint8_t *)malloc(TINFL_LZ_DICT_SIZE);
+  if (!decomp || !window) {
+    end();
+    return false;
+  }
+  return true;
+}
+
+void GzipStream::end() {
+  free(decomp);
+  free(window);
+  decomp = nullptr;
+  window = nullptr;
+}
+
+void GzipStream::reset(HttpBodyStream &in, uint32_t timeout) {
+  src = &in;
+  timeoutMs = timeout;
+  headerDone = false;
+  status = TINFL_STATUS_NEEDS_MORE_INPUT;
+  outHead = outRead = outAvail = 0;
+  inPos = inLen = 0;
+  inTotal = outTotal = 0;
+  crc = 0;
+  tinfl_init(decomp);
+}
+
+// Blocking single-byte read for the header and trailer. -1 at the end of
+// the body or on timeout.
+int GzipStream::srcRead() {
+  uint32_t start = millis();
+  while (src->available() <= 0) {
+    if (src->ended() || millis() - start > timeoutMs) return -1;
+    delay(1);
+  }
+  inTotal++;
+  return src->read();
+}
+
+bool GzipStream::skipBytes(uint16_t n) {
+  while (n--) {
+    if (srcRead() < 0) return false;
+  }
+  return true;
+}
+
+bool GzipStream::skipString() {
+  int c;
+  while ((c = srcRead()) > 0) {
+  }
+  return c == 0;
+}
+
+// RFC 1952 member header; only the deflate payload after it is kept
+bool GzipStream::readHeader() {
+  uint8_t h[10];
+  for (uint8_t i = 0; i < sizeof h; ++i) {
+    int c = srcRead();
+    if (c < 0) return false;
+    h[i] = c;
+  }
+  if (h[0] != GZIP_ID1 || h[1] != GZIP_ID2 || h[2] != GZIP_DEFLATE) return false;
+  uint8_t flags = h[3];
+  if (flags & GZIP_FEXTRA) {
+    int lo = srcRead();
+    int hi = srcRead();
+    if (lo < 0 || hi < 0 || !skipBytes(lo | (hi << 8))) return false;
+  }
+  if ((flags & GZIP_FNAME) && !skipString()) return false;
+  if ((flags & GZIP_FCOMMENT) && !skipString()) return false;
+  if ((flags & GZIP_FHCRC) && !skipBytes(2)) return false;
+  return true;
+}
+
+// RFC 1952 member trailer: CRC-32 and length mod 2^32 of the inflated
+// data, little-endian. Its first bytes may already be staged in `in`.
+bool GzipStream::checkTrailer() {
+  uint8_t t[8];
+  for (uint8_t i = 0; i < sizeof t; ++i) {
+    int c = inPos < inLen ? in[inPos++] : srcRead();
+    if (c < 0) return false;
+    t[i] = c;
+  }
+  uint32_t wantCrc = t[0] | (t[1] << 8) | (t[2] << 16) | ((uint32_t)t[3] << 24);
+  uint32_t wantSize = t[4] | (t[5] << 8) | (t[6] << 16) | ((uint32_t)t[7] << 24);
+  return wantCrc == crc && wantSize == outTotal;
+}
+
+// Inflates whatever input is on hand into the free end of the window. Only
+// called once all earlier output has been read, so nothing unread is
+// overwritten.
+void GzipStream::pump() {
+  if (!headerDone) {
+    if (!readHeader()) {
+      status = TINFL_STATUS_FAILED;
+      return;
+    }
+    headerDone = true;
+  }
+  while (outAvail == 0 && status > TINFL_STATUS_DONE) {
+    if (inPos == inLen && status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+      int avail = src->available();
+      if (avail <= 0) {
+        // The body ended before the deflate stream did
+        if (src->ended()) status = TINFL_STATUS_FAILED;
+        return;
+      }
+      inLen = src->readBytes(in, min((size_t)avail, sizeof in));
+      inPos = 0;
+      inTotal += inLen;
+      if (inLen == 0) return;
+    }
+    size_t inBytes = inLen - inPos;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - outHead;
+    status = tinfl_decompress(decomp, in + inPos, &inBytes, window, window + outHead, &outBytes,
+                              TINFL_FLAG_HAS_MORE_INPUT);
+    inPos += inBytes;
+    crc = esp_rom_crc32_le(crc, window + outHead, outBytes);
+    outAvail = outBytes;
+    outTotal += outBytes;
+    outHead = (outHead + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+    if (status == TINFL_STATUS_DONE && !checkTrailer()) status = TINFL_STATUS_FAILED;
+  }
+}
+
+bool GzipStream::finish() {
+  uint32_t start = millis();
+  while (status > TINFL_STATUS_DONE) {
+    outRead = (outRead + outAvail) & (TINFL_LZ_DICT_SIZE - 1);
+    outAvail = 0;
+    pump();
+    if (outAvail > 0) {
+      start = millis();
+    } else if (status > TINFL_STATUS_DONE) {
+      if (millis() - start > timeoutMs) status = TINFL_STATUS_FAILED;
+      delay(1);
+    }
+  }
+  return status == TINFL_STATUS_DONE;
+}
+
+int GzipStream::available() {
+  if (outAvail == 0 && status > TINFL_STATUS_DONE) pump();
+  return outAvail;
+}
+
+int GzipStream::read() {
+  if (available() <= 0) return -1;
+  uint8_t c = window[outRead];
+  outRead = (outRead + 1) & (TINFL_LZ_DICT_SIZE - 1);
+  outAvail--;
+  return c;
+}
+
+int GzipStream::peek() {
+  if (available() <= 0) return -1;
+  return window[outRead];
+}
+
+static GzipStream shared;
+static std::atomic<bool> sharedInUse(false);
+
+GzipStream *gzipClaim(bool &busy) {
+  bool expected = false;
+  busy = !sharedInUse.compare_exchange_strong(expected, true, std::memory_order_acquire);
+  if (busy) return nullptr;
+  if (shared.begin()) return &shared;
+  sharedInUse.store(false, std::memory_order_release);
+  return nullptr;
+}
+
+void gzipRelease() {
+  shared.end();
+  sharedInUse.store(false, std::memory_order_release);
+}
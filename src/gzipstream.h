@@ -0,0 +1,77 @@
+#ifndef GZIPSTREAM_H
+#define GZIPSTREAM_H
+
+#include <Arduino.h>
+#include "esp_rom_crc.h"
+#include "esp32/rom/miniz.h"
+#include "httpbody.h"
+
+// Input bytes staged per inflate call
+#define GZIP_INPUT_BYTES 256
+
+// Inflates a gzip member read from a response body as the bytes arrive,
+// using the deflater in ROM, and checks its CRC-32 and length trailer. The 32 KB history window doubles as the output buffer,
+// so the only other state is the decompressor itself (about 11 KB). Both
+// are allocated by begin() and freed by end(), so an inflater only holds
+// memory while a response is being read.
+class GzipStream : public Stream {
+ public:
+  GzipStream() : src(nullptr), decomp(nullptr), window(nullptr) {}
+  ~GzipStream() { end(); }
+
+  // False if the buffers could not be allocated
+  bool begin();
+  void end();
+
+  // Starts a new member read from `in`
+  void reset(HttpBodyStream &in, uint32_t timeoutMs);
+  // Inflates and drops whatever the reader left, through the trailer. True
+  // if the member ended there and its CRC-32 and length matched.
+  bool finish();
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+
+  // Corrupt, cut short, or the trailer did not match
+  bool failed() const { return status < TINFL_STATUS_DONE; }
+  uint32_t compressedBytes() const { return inTotal; }
+  uint32_t inflatedBytes() const { return outTotal; }
+
+ private:
+  bool readHeader();
+  bool skipBytes(uint16_t n);
+  bool skipString();
+  bool checkTrailer();
+  int srcRead();
+  void pump();
+
+  HttpBodyStream *src;
+  tinfl_decompressor *decomp;
+  uint8_t *window;
+  uint32_t timeoutMs;
+  bool headerDone;
+  tinfl_status status;
+  // Unread output is window[outRead .. outRead + outAvail), wrapping
+  uint16_t outHead;
+  uint16_t outRead;
+  uint16_t outAvail;
+  uint8_t in[GZIP_INPUT_BYTES];
+  uint16_t inPos;
+  uint16_t inLen;
+  uint32_t inTotal;
+  uint32_t outTotal;
+  uint32_t crc;
+};
+
+// The one inflater every WeatherClient shares. With a GzipStream per fetch
+// worker their 43 KB each could all be live at once, next to the image
+// cache; this way at most one response is inflated at a time. Returns it
+// with its buffers allocated, or null: `busy` tells whether another
+// request holds it or the memory could not be had. Never blocks.
+GzipStream *gzipClaim(bool &busy);
+// Frees the buffers and lets the next request have the inflater
+void gzipRelease();
+
+#endif
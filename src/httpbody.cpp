@@ -0,0 +1,105 @@
+#include <Arduino.h>
+#include "httpbody.h"
+
+HttpBodyStream::HttpBodyStream(Stream &raw, int32_t length, bool chunked, uint32_t timeoutMs)
+    : raw(raw), chunked(chunked), finished(false), failed(false),
+      left(chunked ? 0 : length), timeoutMs(timeoutMs) {
+  if (!chunked && length == 0) finished = true;
+}
+
+// Blocking single-byte read with the body timeout. -1 on timeout.
+int HttpBodyStream::rawRead() {
+  uint32_t start = millis();
+  while (raw.available() <= 0) {
+    if (millis() - start > timeoutMs) return -1;
+    delay(1);
+  }
+  return raw.read();
+}
+
+// Parses "<hex size>[;ext]\r\n". A zero size ends the body, after any
+// trailer lines up to the blank one.
+bool HttpBodyStream::nextChunk() {
+  int32_t size = 0;
+  int digits = 0;
+  int c;
+  while ((c = rawRead()) >= 0 && c != '\n') {
+    if (c == ';' || digits < 0) {
+      digits = -1; // extension, ignored
+    } else if (isxdigit(c)) {
+      size = size * 16 + (isdigit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+      digits++;
+    } else if (c != '\r' && c != ' ') {
+      return false;
+    }
+  }
+  if (c < 0 || digits == 0) return false;
+
+  if (size == 0) {
+    // Trailers end at an empty line
+    int lineLen = 0;
+    while ((c = rawRead()) >= 0) {
+      if (c == '\n') {
+        if (lineLen == 0) break;
+        lineLen = 0;
+      } else if (c != '\r') {
+        lineLen++;
+      }
+    }
+    if (c < 0) return false;
+    finished = true;
+  }
+  left = size;
+  return true;
+}
+
+int HttpBodyStream::available() {
+  if (finished || failed) return 0;
+  if (chunked && left == 0) {
+    if (!nextChunk()) {
+      failed = true;
+      return 0;
+    }
+    if (finished) return 0;
+  }
+  int n = raw.available();
+  if (left >= 0 && n > left) n = left;
+  return n;
+}
+
+int HttpBodyStream::read() {
+  if (available() <= 0) return -1;
+  int c = raw.read();
+  if (c < 0) return -1;
+  if (left > 0 && --left == 0) {
+    if (!chunked) {
+      finished = true;
+    } else if (rawRead() != '\r' || rawRead() != '\n') {
+      // Every chunk's data is followed by CRLF
+      failed = true;
+    }
+  }
+  return c;
+}
+
+int HttpBodyStream::peek() {
+  if (available() <= 0) return -1;
+  return raw.peek();
+}
+
+bool HttpBodyStream::drain() {
+  // A close-delimited body is never reusable; nothing to save
+  if (left < 0 && !chunked) return false;
+  uint32_t start = millis();
+  while (!finished && !failed) {
+    if (available() > 0) {
+      read();
+      start = millis();
+    } else if (millis() - start > timeoutMs) {
+      return false;
+    } else {
+      delay(1);
+    }
+  }
+  return !failed;
+}
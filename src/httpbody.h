@@ -0,0 +1,43 @@
+#ifndef HTTPBODY_H
+#define HTTPBODY_H
+
+#include <Arduino.h>
+
+// One response body read off a socket that stays open afterwards. Bytes
+// are framed by Content-Length, by chunked transfer coding, or (length < 0
+// and not chunked) by the server closing the connection. available() never
+// reports bytes past the end of the body, so a parser layered on top
+// cannot swallow the start of the next response.
+class HttpBodyStream : public Stream {
+ public:
+  HttpBodyStream(Stream &raw, int32_t length, bool chunked, uint32_t timeoutMs);
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+
+  // Reads and discards whatever is left of the body, including the chunked
+  // terminator. False if the body could not be read to its end, in which
+  // case the connection is not safe to reuse.
+  bool drain();
+
+  bool done() const { return finished; }
+  // Nothing more will come: read to its end, or framing failed
+  bool ended() const { return finished || failed; }
+
+ private:
+  bool nextChunk();
+  int rawRead();
+
+  Stream &raw;
+  bool chunked;
+  bool finished;
+  bool failed;
+  // Bytes left in the body, or in the current chunk when chunked; -1 when
+  // the body runs until the connection closes
+  int32_t left;
+  uint32_t timeoutMs;
+};
+
+#endif
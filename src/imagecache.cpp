@@ -0,0 +1,109 @@
+#include <Arduino.h>
+#include "imagecache.h"
+#include "log.h"
+
+static CachedImage slots[IMAGE_CACHE_SLOTS];
+static ImageCacheStats stats;
+static uint32_t budget = 0;
+static uint32_t useClock = 0;
+
+void imageCacheSetBudget(uint32_t bytes) {
+  budget = bytes;
+}
+
+uint32_t imageCacheBudget() {
+  if (budget) return budget;
+  return psramFound() ? IMAGE_CACHE_PSRAM_BUDGET : IMAGE_CACHE_BUDGET;
+}
+
+static void release(CachedImage &entry) {
+  if (entry.pixels) {
+    heap_caps_free(entry.pixels);
+    stats.bytesHeld -= entry.bytes;
+  }
+  memset(&entry, 0, sizeof entry);
+}
+
+const CachedImage *imageCacheFind(const char *path, uint32_t fileSize, time_t mtime) {
+  for (int i = 0; i < IMAGE_CACHE_SLOTS; ++i) {
+    CachedImage &entry = slots[i];
+    if (entry.valid && entry.fileSize == fileSize && entry.mtime == mtime &&
+        strcmp(entry.path, path) == 0) {
+      entry.lastUse = ++useClock;
+      stats.hits++;
+      return &entry;
+    }
+  }
+  stats.misses++;
+  return nullptr;
+}
+
+static CachedImage *leastRecentlyUsed() {
+  CachedImage *oldest = nullptr;
+  for (int i = 0; i < IMAGE_CACHE_SLOTS; ++i) {
+    if (slots[i].pixels && (!oldest || slots[i].lastUse < oldest->lastUse)) oldest = &slots[i];
+  }
+  return oldest;
+}
+
+static void evict(CachedImage &entry) {
+  LOG_DEBUG("Image cache evict %s", entry.path);
+  release(entry);
+  stats.evictions++;
+}
+
+CachedImage *imageCacheReserve(const char *path, uint32_t fileSize, time_t mtime,
+                               uint16_t width, uint16_t height) {
+  uint32_t bytes = (uint32_t)width * height * sizeof(uint16_t);
+  if (strlen(path) >= IMAGE_CACHE_PATH_LEN || bytes > imageCacheBudget()) return nullptr;
+
+  // Drop any stale copy of the same path first
+  for (int i = 0; i < IMAGE_CACHE_SLOTS; ++i) {
+    if (slots[i].pixels && strcmp(slots[i].path, path) == 0) release(slots[i]);
+  }
+
+  while (stats.bytesHeld + bytes > imageCacheBudget()) {
+    evict(*leastRecentlyUsed());
+  }
+
+  CachedImage *entry = nullptr;
+  for (int i = 0; i < IMAGE_CACHE_SLOTS && !entry; ++i) {
+    if (!slots[i].pixels) entry = &slots[i];
+  }
+  if (!entry) {
+    entry = leastRecentlyUsed();
+    evict(*entry);
+  }
+
+  bool inPsram = psramFound();
+  uint16_t *pixels = (uint16_t *)heap_caps_malloc(bytes, inPsram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+  if (!pixels) {
+    LOG_WARN("Image cache: no memory for %u bytes", bytes);
+    return nullptr;
+  }
+
+  strcpy(entry->path, path);
+  entry->fileSize = fileSize;
+  entry->mtime = mtime;
+  entry->width = width;
+  entry->height = height;
+  entry->pixels = pixels;
+  entry->bytes = bytes;
+  entry->lastUse = ++useClock;
+  entry->inPsram = inPsram;
+  entry->valid = false;
+  stats.bytesHeld += bytes;
+  return entry;
+}
+
+void imageCacheCommit(CachedImage *entry) {
+  if (entry) entry->valid = true;
+}
+
+void imageCacheAbort(CachedImage *entry) {
+  if (entry) release(*entry);
+}
+
+ImageCacheStats imageCacheStats() {
+  return stats;
+}
@@ -0,0 +1,53 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+// Default byte budget for decoded pixels in internal RAM, and the larger one
+// used when the board has PSRAM. imageCacheSetBudget() overrides both.
+#ifndef IMAGE_CACHE_BUDGET
+#define IMAGE_CACHE_BUDGET (96 * 1024)
+#endif
+#ifndef IMAGE_CACHE_PSRAM_BUDGET
+#define IMAGE_CACHE_PSRAM_BUDGET (1024 * 1024)
+#endif
+#define IMAGE_CACHE_SLOTS 4
+#define IMAGE_CACHE_PATH_LEN 32
+
+// A decoded image: wire-order RGB565, top-down, ready for one push.
+// Keyed by path plus the file's size and modification time so a replaced
+// asset is decoded again.
+struct CachedImage {
+  char path[IMAGE_CACHE_PATH_LEN];
+  uint32_t fileSize;
+  time_t mtime;
+  uint16_t width;
+  uint16_t height;
+  uint16_t *pixels;
+  uint32_t bytes;
+  uint32_t lastUse;
+  bool inPsram;
+  bool valid;
+};
+
+struct ImageCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t bytesHeld;
+};
+
+void imageCacheSetBudget(uint32_t bytes);
+uint32_t imageCacheBudget();
+// Returns a ready entry or nullptr, counting a hit or a miss
+const CachedImage *imageCacheFind(const char *path, uint32_t fileSize, time_t mtime);
+// Allocate pixel storage for an image about to be decoded, evicting least
+// recently used entries to stay under budget. nullptr if it cannot fit.
+CachedImage *imageCacheReserve(const char *path, uint32_t fileSize, time_t mtime,
+                               uint16_t width, uint16_t height);
+void imageCacheCommit(CachedImage *entry);
+void imageCacheAbort(CachedImage *entry);
+ImageCacheStats imageCacheStats();
+
+#endif
@@ -0,0 +1,179 @@
+#include <Arduino.h>
+#include "jsonscan.h"
+
+JsonScanner::JsonScanner(const JsonPathNode *nodes, uint8_t count, ValueHandler onValue, void *ctx)
+    : nodes(nodes), count(count), onValue(onValue), onClose(nullptr), ctx(ctx), in(nullptr), timeoutMs(0),
+      pos(0), len(0), consumed(0), arrays(0) {}
+
+bool JsonScanner::scan(Stream &stream, uint32_t timeout) {
+  in = &stream;
+  timeoutMs = timeout;
+  pos = len = 0;
+  consumed = 0;
+  arrays = 0;
+  return parseValue(0, 0);
+}
+
+uint16_t JsonScanner::index(uint8_t up) const {
+  return up < arrays ? indices[arrays - 1 - up] : 0;
+}
+
+// Next byte of input, refilling from the stream only with what it already
+// has so readBytes() never blocks. -1 on timeout.
+int JsonScanner::next() {
+  if (pos < len) return buf[pos++];
+  uint32_t start = millis();
+  int avail;
+  while ((avail = in->available()) <= 0) {
+    if (millis() - start > timeoutMs) return -1;
+    delay(1);
+  }
+  len = in->readBytes(buf, min((size_t)avail, sizeof buf));
+  if (len == 0) return -1;
+  consumed += len;
+  pos = 0;
+  return buf[pos++];
+}
+
+// First non-whitespace byte, left unconsumed
+int JsonScanner::peekToken() {
+  for (;;) {
+    int c = next();
+    if (c < 0) return -1;
+    if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+      --pos;
+      return c;
+    }
+  }
+}
+
+uint8_t JsonScanner::child(uint8_t node, const char *key) const {
+  if (node == JSON_NO_NODE) return JSON_NO_NODE;
+  for (uint8_t i = 1; i < count; ++i) {
+    if (nodes[i].parent == node && strcmp(nodes[i].key, key) == 0) return i;
+  }
+  return JSON_NO_NODE;
+}
+
+bool JsonScanner::parseValue(uint8_t node, uint8_t depth) {
+  int c = peekToken();
+  if (c == '{' || c == '[') {
+    if (!(c == '{' ? parseObject(node, depth) : parseArray(node, depth))) return false;
+    if (node != JSON_NO_NODE && onClose) onClose(ctx, node);
+    return true;
+  }
+
+  char text[JSON_MAX_SCALAR];
+  bool isString = c == '"';
+  if (!(isString ? parseString(text, sizeof text) : parseLiteral(text, sizeof text))) return false;
+  if (node != JSON_NO_NODE && onValue) onValue(ctx, node, text, isString);
+  return true;
+}
+
+bool JsonScanner::parseObject(uint8_t node, uint8_t depth) {
+  if (depth >= JSON_MAX_DEPTH) return false;
+  next(); // '{'
+  if (peekToken() == '}') {
+    next();
+    return true;
+  }
+  for (;;) {
+    char key[JSON_MAX_SCALAR];
+    if (peekToken() != '"' || !parseString(key, sizeof key)) return false;
+    if (peekToken() != ':') return false;
+    next();
+    if (!parseValue(child(node, key), depth + 1)) return false;
+
+    int c = peekToken();
+    next();
+    if (c == '}') return true;
+    if (c != ',') return false;
+  }
+}
+
+bool JsonScanner::parseArray(uint8_t node, uint8_t depth) {
+  if (depth >= JSON_MAX_DEPTH) return false;
+  next(); // '['
+  if (peekToken() == ']') {
+    next();
+    return true;
+  }
+  uint8_t slot = arrays++;
+  indices[slot] = 0;
+  for (;;) {
+    uint8_t element = JSON_NO_NODE;
+    if (node != JSON_NO_NODE) {
+      char key[8];
+      snprintf(key, sizeof key, "%u", indices[slot]);
+      element = child(node, key);
+      if (element == JSON_NO_NODE) element = child(node, "*");
+    }
+    if (!parseValue(element, depth + 1)) return false;
+
+    int c = peekToken();
+    next();
+    if (c == ']') break;
+    if (c != ',') return false;
+    indices[slot]++;
+  }
+  arrays--;
+  return true;
+}
+
+// Copies at most size-1 bytes into out; the rest of a long string is skipped.
+// \u escapes outside ASCII come out as '?'.
+bool JsonScanner::parseString(char *out, size_t size) {
+  next(); // opening quote
+  size_t n = 0;
+  for (;;) {
+    int c = next();
+    if (c < 0) return false;
+    if (c == '"') break;
+    if (c == '\\') {
+      c = next();
+      switch (c) {
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u': {
+          uint16_t code = 0;
+          for (int i = 0; i < 4; ++i) {
+            int h = next();
+            if (h < 0 || !isxdigit(h)) return false;
+            code = code * 16 + (isdigit(h) ? h - '0' : (h | 0x20) - 'a' + 10);
+          }
+          c = code < 0x80 ? code : '?';
+          break;
+        }
+        case '"': case '\\': case '/': break;
+        default: return false;
+      }
+    }
+    if (n + 1 < size) out[n++] = c;
+  }
+  out[n] = '\0';
+  return true;
+}
+
+// Numbers, true, false and null
+bool JsonScanner::parseLiteral(char *out, size_t size) {
+  size_t n = 0;
+  for (;;) {
+    int c = next();
+    if (c < 0) {
+      // A bare literal may legitimately end the stream
+      if (n == 0) return false;
+      break;
+    }
+    if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      --pos;
+      break;
+    }
+    if (!isalnum(c) && c != '-' && c != '+' && c != '.') return false;
+    if (n + 1 < size) out[n++] = c;
+  }
+  out[n] = '\0';
+  return n > 0;
+}
@@ -0,0 +1,72 @@
+#ifndef JSONSCAN_H
+#define JSONSCAN_H
+
+#include <Arduino.h>
+
+#define JSON_NO_NODE 0xFF
+#define JSON_MAX_DEPTH 16
+// Longest scalar handed to a value handler; longer strings are truncated
+#define JSON_MAX_SCALAR 48
+
+// One node of a path trie. Node 0 is the document root; every other node
+// names a member key under its parent, or an array index ("0", "1", ... or
+// "*" for any element). The table is the scanner's state machine: each
+// open object or array sits on a node, or on JSON_NO_NODE once it has left
+// every path of interest.
+struct JsonPathNode {
+  uint8_t parent;
+  const char *key;
+};
+
+// Single-pass, allocation-free JSON reader. It walks the token stream once,
+// tracks where it is in the trie, and reports only the scalars that land on
+// a node. Everything else is tokenized and dropped without being stored.
+class JsonScanner {
+ public:
+  // text is NUL-terminated; isString tells "12" from 12
+  typedef void (*ValueHandler)(void *ctx, uint8_t node, const char *text, bool isString);
+  // Called when an object or array sitting on a node ends
+  typedef void (*CloseHandler)(void *ctx, uint8_t node);
+
+  JsonScanner(const JsonPathNode *nodes, uint8_t count, ValueHandler onValue, void *ctx);
+
+  void setCloseHandler(CloseHandler handler) { onClose = handler; }
+
+  // Reads one complete JSON value from `in`. Bytes that were already
+  // buffered behind it may be consumed too. False on malformed input or if
+  // the stream stalls for longer than timeoutMs.
+  bool scan(Stream &in, uint32_t timeoutMs);
+
+  // Index of the element being read in the innermost enclosing array, or
+  // `up` arrays further out
+  uint16_t index(uint8_t up = 0) const;
+
+  uint32_t bytesRead() const { return consumed; }
+
+ private:
+  int next();
+  int peekToken();
+  uint8_t child(uint8_t node, const char *key) const;
+  bool parseValue(uint8_t node, uint8_t depth);
+  bool parseObject(uint8_t node, uint8_t depth);
+  bool parseArray(uint8_t node, uint8_t depth);
+  bool parseString(char *out, size_t size);
+  bool parseLiteral(char *out, size_t size);
+
+  const JsonPathNode *nodes;
+  uint8_t count;
+  ValueHandler onValue;
+  CloseHandler onClose;
+  void *ctx;
+
+  Stream *in;
+  uint32_t timeoutMs;
+  uint8_t buf[64];
+  uint8_t pos;
+  uint8_t len;
+  uint32_t consumed;
+  uint16_t indices[JSON_MAX_DEPTH];
+  uint8_t arrays;
+};
+
+#endif
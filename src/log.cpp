@@ -0,0 +1,176 @@
+#include <Arduino.h>
+#include <atomic>
+#include "log.h"
+
+#define LOG_LINE_BYTES 160
+
+// A queued message: the format string pointer doubles as its id (literals
+// live in flash), followed by the raw argument words. Formatting happens
+// later in the drain task.
+struct LogSlot {
+  std::atomic<uint32_t> seq;
+  uint8_t level;
+  uint8_t count;
+  uint8_t types[LOG_MAX_ARGS];
+  const char *fmt;
+  uint32_t values[LOG_MAX_ARGS];
+  char text[LOG_TEXT_BYTES];
+};
+
+// Bounded multi-producer/single-consumer queue. Producers claim a slot by
+// advancing head with a CAS and publish it through the slot's sequence
+// number; the drain task is the only reader.
+struct LogRing {
+  LogSlot slots[LOG_RING_SLOTS];
+  LogRing() {
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; ++i) slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+  LogSlot &operator[](uint32_t i) { return slots[i]; }
+};
+
+static LogRing ring;
+static std::atomic<uint32_t> head(0);
+// Advanced by the drain task once a message is on the wire
+static std::atomic<uint32_t> tail(0);
+static std::atomic<uint32_t> dropped(0);
+static std::atomic<uint32_t> dropsReported(0);
+static TaskHandle_t drainTask = nullptr;
+
+static const char levelTags[] = { '-', 'E', 'W', 'I', 'D', 'T' };
+
+void logPush(uint8_t level, const char *fmt, const LogArg *args, uint8_t count) {
+  uint32_t pos = head.load(std::memory_order_relaxed);
+  LogSlot *slot;
+  for (;;) {
+    slot = &ring[pos & (LOG_RING_SLOTS - 1)];
+    int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      // Full: never block a hot loop on the UART
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->level = level;
+  slot->count = count;
+  slot->fmt = fmt;
+  size_t used = 0;
+  for (uint8_t i = 0; i < count; ++i) {
+    slot->types[i] = args[i].type;
+    if (args[i].type == LogArg::STR) {
+      // Store the offset of the copy rather than the caller's pointer
+      const char *s = args[i].s ? args[i].s : "(null)";
+      size_t room = LOG_TEXT_BYTES - used;
+      size_t len = room ? min(strlen(s), room - 1) : 0;
+      slot->values[i] = used;
+      if (room) {
+        memcpy(slot->text + used, s, len);
+        slot->text[used + len] = '\0';
+        used += len + 1;
+      } else {
+        slot->values[i] = LOG_TEXT_BYTES - 1;
+      }
+    } else {
+      slot->values[i] = args[i].u;
+    }
+  }
+  slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+uint32_t logDropped() {
+  return dropped.load(std::memory_order_relaxed);
+}
+
+// Format one conversion spec ("%-5.1f") against a captured argument
+static int formatArg(char *out, size_t size, const char *spec, char conv, const LogSlot &slot, uint8_t i) {
+  uint32_t raw = slot.values[i];
+  switch (slot.types[i]) {
+    case LogArg::STR:
+      return snprintf(out, size, spec, conv == 's' ? slot.text + raw : "?");
+    case LogArg::FLOAT: {
+      float f;
+      memcpy(&f, &raw, sizeof f);
+      if (strchr("fFeEgGaA", conv)) return snprintf(out, size, spec, (double)f);
+      return snprintf(out, size, spec, (int)f);
+    }
+    case LogArg::INT:
+      if (strchr("fFeEgGaA", conv)) return snprintf(out, size, spec, (double)(int32_t)raw);
+      return snprintf(out, size, spec, (int)(int32_t)raw);
+    default:
+      if (strchr("fFeEgGaA", conv)) return snprintf(out, size, spec, (double)raw);
+      return snprintf(out, size, spec, (unsigned)raw);
+  }
+}
+
+static size_t formatSlot(char *line, size_t size, const LogSlot &slot) {
+  size_t n = snprintf(line, size, "[%c] ", levelTags[slot.level < sizeof levelTags ? slot.level : 0]);
+  uint8_t arg = 0;
+  for (const char *p = slot.fmt; *p && n < size - 1; ++p) {
+    if (*p != '%') { line[n++] = *p; continue; }
+    if (p[1] == '%') { line[n++] = '%'; ++p; continue; }
+
+    // Copy flags/width/precision, drop length modifiers: arguments are
+    // passed back at their stored width.
+    char spec[16];
+    size_t k = 0;
+    spec[k++] = *p++;
+    while (*p && strchr("-+ #0123456789.", *p) && k < sizeof spec - 2) spec[k++] = *p++;
+    while (*p && strchr("hlzjtL", *p)) ++p;
+    if (!*p) break;
+    char conv = *p;
+    if (strchr("di", conv)) conv = 'd';
+    spec[k++] = conv;
+    spec[k] = '\0';
+
+    if (arg >= slot.count) break;
+    int w = formatArg(line + n, size - n, spec, conv, slot, arg++);
+    if (w > 0) n = min(n + w, size - 1);
+  }
+  if (n > 0 && line[n - 1] != '\n' && n < size - 1) line[n++] = '\n';
+  line[n] = '\0';
+  return n;
+}
+
+// Runs at idle priority so the UART is only fed when nothing else is ready
+static void logDrainTask(void *) {
+  char line[LOG_LINE_BYTES];
+  for (;;) {
+    uint32_t pos = tail.load(std::memory_order_relaxed);
+    LogSlot &slot = ring[pos & (LOG_RING_SLOTS - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+      uint32_t drops = logDropped();
+      uint32_t reported = dropsReported.load(std::memory_order_relaxed);
+      if (drops != reported) {
+        Serial.printf("[W] log ring full, %u messages dropped\n", drops - reported);
+        dropsReported.store(drops, std::memory_order_release);
+      }
+      vTaskDelay(pdMS_TO_TICKS(20));
+      continue;
+    }
+    size_t n = formatSlot(line, sizeof line, slot);
+    slot.seq.store(pos + LOG_RING_SLOTS, std::memory_order_release);
+    Serial.write((const uint8_t *)line, n);
+    tail.store(pos + 1, std::memory_order_release);
+  }
+}
+
+void logBegin(unsigned long baud) {
+  Serial.begin(baud);
+  if (xTaskCreate(logDrainTask, "logDrain", 3072, nullptr, tskIDLE_PRIORITY,
+                  &drainTask) != pdPASS) {
+    drainTask = nullptr;
+  }
+}
+
+void logFlush() {
+  if (!drainTask) return;
+  uint32_t until = head.load(std::memory_order_acquire);
+  while ((int32_t)(tail.load(std::memory_order_acquire) - until) < 0 ||
+         dropsReported.load(std::memory_order_acquire) != logDropped()) {
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+}
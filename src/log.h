@@ -0,0 +1,89 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Compile-time log levels. Anything above LOG_LEVEL expands to an empty
+// statement, so its arguments are never evaluated and no call is emitted.
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_MAX_ARGS 4
+// Ring capacity, must be a power of two
+#define LOG_RING_SLOTS 64
+// Bytes per slot for copies of string arguments, terminators included
+#define LOG_TEXT_BYTES 48
+
+// One captured printf argument. Strings are copied into the ring slot when
+// the message is queued, so callers may pass temporaries.
+struct LogArg {
+  enum Type : uint8_t { INT, UINT, FLOAT, STR };
+  Type type;
+  union {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char *s;
+  };
+  LogArg(int v) : type(INT), i(v) {}
+  LogArg(long v) : type(INT), i(v) {}
+  LogArg(unsigned int v) : type(UINT), u(v) {}
+  LogArg(unsigned long v) : type(UINT), u(v) {}
+  LogArg(double v) : type(FLOAT), f(v) {}
+  LogArg(const char *v) : type(STR), s(v) {}
+  LogArg(const String &v) : type(STR), s(v.c_str()) {}
+};
+
+void logBegin(unsigned long baud);
+void logPush(uint8_t level, const char *fmt, const LogArg *args, uint8_t count);
+uint32_t logDropped();
+// Blocks until everything queued so far, and the count of anything
+// dropped, has been written out. Returns at once before logBegin().
+void logFlush();
+
+template <typename... Args>
+inline void logWrite(uint8_t level, const char *fmt, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+  const LogArg packed[] = { LogArg(args)..., LogArg(0) };
+  logPush(level, fmt, packed, sizeof...(Args));
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do { } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) logWrite(LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) do { } while (0)
+#endif
+
+#endif
@@ -9,20 +9,47 @@ in order to calculate fishing quality for the day to load onto a TFT display
 #include <HTTPClient.h>
 #include <TFT_eSPI.h>
 #include <SPI.h>
-#include <ArduinoJson.h>
 #include <draw.h>
 #include <SD.h>
 #include "keys.h"
-#define BUFFPIXEL 20
+#include "log.h"
+#include "weatherclient.h"
+#include "fetchpool.h"
+#include "weathercache.h"
+#include "pollschedule.h"
+#include "scoremodel.h"
+#include "solunar.h"
+#include "suncalc.h"
+#include "timesync.h"
+#include "report.h"
 
 TFT_eSPI tft = TFT_eSPI();
 
 const char* ssid = WIFI;
 const char* password = WIFI_PASS;
 
-String apiKey = String(API_KEY);
-String location_Lincoln = "Lincoln,NE";
-String location_Omaha = "Omaha,NE";
+// Shown top to bottom in this order
+String locations[] = { "Lincoln,NE", "Omaha,NE" };
+const uint8_t locationCount = sizeof locations / sizeof locations[0];
+// Species scored for each location, side by side in enum order
+const uint8_t locationSpecies[] = {
+  SPECIES_BIT(SPECIES_CATFISH) | SPECIES_BIT(SPECIES_BASS),
+  SPECIES_BIT(SPECIES_CATFISH),
+};
+static_assert(sizeof locationSpecies == sizeof locations / sizeof locations[0],
+              "one species mask per location");
+// Where each location is, for the sun and moon
+const GeoPoint locationPoints[] = {
+  { 40.8136f, -96.7026f },
+  { 41.2565f, -95.9345f },
+};
+static_assert(sizeof locationPoints / sizeof locationPoints[0] == locationCount,
+              "one point per location");
+// POSIX TZ rules for the locations' local day (US Central), which sun and
+// moon times are given in
+#ifndef LOCAL_TZ
+#define LOCAL_TZ "CST6CDT,M3.2.0,M11.1.0"
+#endif
 
 void tftInit() {
   tft.init();
@@ -31,176 +58,126 @@ void tftInit() {
   tft.setTextColor(TFT_WHITE, TFT_BLACK);
   tft.setTextSize(2);
   tft.setCursor(10,10);
+  reportInit();
+  drawInit();
 }
 
-void rectMeter(int fishScore){
-  int16_t y;
-  y = tft.getCursorY();
-  int barWidth = map(fishScore, 0, 100, 0, tft.width() - 20);
-
-  uint16_t color = TFT_RED;
-  if (fishScore >= 80) {
-        color = TFT_GREEN;
-      } else if (fishScore >= 60) {
-        color = TFT_YELLOW;
-      } else if (fishScore >= 40) {
-        color = TFT_ORANGE;
-      }
-  tft.drawRect(10, y+10, tft.width()-20, 20, TFT_WHITE);
-  tft.fillRect(10, y+10, barWidth, 20, color);
+// Left out of the fish art so the report shows through. Black would also
+// punch out the fish's own outline and eyes, so the key is a color the art
+// does not use: tools/img2raw.py --background writes the backdrop of
+// fish.565 and catfish.565 as this and moves any real magenta off it.
+#ifndef FISH_COLOR_KEY
+#define FISH_COLOR_KEY TFT_MAGENTA
+#endif
+
+static WeatherSample samples[sizeof locations / sizeof locations[0]];
+// Kept from the last fetch of each location; empty until then
+static HourlyForecast hourly[sizeof locations / sizeof locations[0]];
+static int codes[sizeof locations / sizeof locations[0]];
+// Locations served from the cache this refresh, and those whose cached
+// record was too old but can stand in if the fetch fails
+static uint32_t cachedMask;
+static uint32_t staleMask;
+// Worked out once per local day
+static SolunarCache solunar[sizeof locations / sizeof locations[0]];
+static SunDay sun[sizeof locations / sizeof locations[0]];
+
+static void onWeatherReady(uint8_t i, void *) {
+  // The previous report stays up until the first new one is ready, then
+  // is drawn over line by line
+  if (i == 0) {
+    reportRestart();
+  }
+  // Today's sun times, cached with the record for a reboot before the clock
+  time_t now = time(nullptr);
+  LocalDay today;
+  if (localDayOf(now, today) && sun[i].dayNumber == today.dayNumber) {
+    samples[i].sunriseMin = sun[i].sunrise;
+    samples[i].sunsetMin = sun[i].sunset;
+  }
+  if (!(cachedMask & (1UL << i)) && codes[i] == 200) {
+    weatherCacheStore(locations[i], samples[i]);
+    LOG_DEBUG("%s: %d forecast hours", locations[i], (int)hourly[i].hours);
+    solunarFill(solunar[i], hourly[i]);
+  }
+  // A connection failure leaves the loaded record untouched
+  if ((staleMask & (1UL << i)) && codes[i] < 0 && codes[i] != WEATHER_PARSE_FAILED) {
+    LOG_WARN("%s fetch failed (%d), showing cached report", locations[i], codes[i]);
+    showWeather(locations[i], 200, samples[i], locationSpecies[i], solunar[i], now);
+    return;
+  }
+  showWeather(locations[i], codes[i], samples[i], locationSpecies[i], solunar[i], now,
+              &hourly[i]);
 }
 
-int fishScore(int cloud,int wind_mph,float pressure,float temp_f,int rainChance) {
-  int rating = 0;
-
-      //Cloud ideal 80+
-      if (cloud >= 80){
-        rating += 20;
-      } else if (cloud >= 50 && cloud < 80){
-        rating += 10;
-      } else {
-        rating += 5;
-      }
-
-      //Wind ideal < 10
-      if (wind_mph <= 10.0){
-        rating += 20;
-      } else if (wind_mph > 10.0 && wind_mph <= 20.0){
-        rating += 10;
-      } else {
-        rating += 5;
-      }
-
-      //Pressure ideal
-      if (pressure >= 29.8 && pressure <= 30.2) {
-        rating += 20;
-      } else if (pressure < 29.6) {
-        rating += 5;
-      }
-
-      //Temp ideal 60-75 F
-      if (temp_f >= 60.0 && temp_f <= 75.0) {
-        rating += 20;
-      } else if (temp_f >= 50.0 || temp_f <= 85.0) {
-        rating += 10;
-      } else {
-        rating += 5;
-      }
-
-      //Rain
-      if (rainChance >= 0 && rainChance <= 30) {
-        rating += 20;
-      } else if (rainChance > 60) {
-        rating += 5;
-      }
-    
-  return rating;
+// Draws whatever the cache holds, however old, so there is something on
+// screen before the network comes up
+void showCachedWeather() {
+  time_t now = time(nullptr);
+  reportRestart();
+  for (uint8_t i = 0; i < locationCount; ++i) {
+    if (weatherCacheLookup(locations[i], samples[i], now) != WEATHER_CACHE_MISS) {
+      showWeather(locations[i], 200, samples[i], locationSpecies[i], solunar[i], now);
+    }
+  }
+  reportFinish();
 }
 
-void fetchWeather(String location) {
-  if (WiFi.status() == WL_CONNECTED) {
-    HTTPClient http;
-
-    String url = "http://api.weatherapi.com/v1/forecast.json?key=" + apiKey +
-                 "&q=" + location + "&days=1&aqi=no&alerts=no";
-    http.begin(url);
-    int httpCode = http.GET();
-
-    if (httpCode > 0) {
-      String payload = http.getString();
-      Serial.println(payload); // Debug: see raw JSON
-
-      // Build a filter to only keep what we care about
-      StaticJsonDocument<512> filter;
-      filter["current"]["temp_f"] = true;
-      filter["current"]["wind_mph"] = true;
-      filter["current"]["wind_dir"] = true;
-      filter["forecast"]["forecastday"][0]["astro"]["sunrise"] = true;
-      filter["forecast"]["forecastday"][0]["astro"]["sunset"] = true;
-      filter["current"]["pressure_in"] = true;
-      filter["forecast"]["forecastday"][0]["day"]["daily_chance_of_rain"] = true;
-      filter["current"]["cloud"] = true;
-      
-
-      // Document to hold filtered data
-      DynamicJsonDocument doc(4096);
-
-      // Deserialize with filter
-      DeserializationError error = deserializeJson(
-          doc, payload, DeserializationOption::Filter(filter));
-
-      if (error) {
-        Serial.print("deserializeJson() failed: ");
-        Serial.println(error.f_str());
-        tft.fillScreen(TFT_BLACK);
-        tft.setCursor(10, 10);
-        tft.println("PARSE ERROR");
-        return;
-      }
-
-      // Handle WeatherAPI errors
-      if (doc.containsKey("error")) {
-        const char* msg = doc["error"]["message"];
-        Serial.print("WeatherAPI error: ");
-        Serial.println(msg);
-        tft.fillScreen(TFT_BLACK);
-        tft.setCursor(10, 10);
-        tft.printf("API error: %s\n", msg);
-        return;
-      }
-
-      // Extract filtered values
-      float temp_f = doc["current"]["temp_f"] | -99.0;
-      int wind_mph = doc["current"]["wind_mph"] | -1.0;
-      const char* wind_dir = doc["current"]["wind_dir"] | "?";
-      const char* sunrise = doc["forecast"]["forecastday"][0]["astro"]["sunrise"] | "N/A";
-      const char* sunset = doc["forecast"]["forecastday"][0]["astro"]["sunset"] | "N/A";
-      float pressure = doc["current"]["pressure_in"] | -1;
-      int rainChance = doc["forecast"]["forecastday"][0]["day"]["daily_chance_of_rain"] | -1;
-      int cloud = doc["current"]["cloud"] | -1;
-
-      int score = fishScore(cloud, wind_mph, pressure, temp_f, rainChance);
-
-      String fishRate;
-      
-      if (score >= 80) {
-        fishRate = "Excellent";
-      } else if (score >= 60) {
-        fishRate = "Good";
-      } else if (score >= 40) {
-        fishRate = "Fair";
-      } else {
-        fishRate = "Poor";
-      }
-
-      // Display on TFT
-      tft.printf("Location: %s\n", location);
-      tft.printf("Temp: %.1f F\n", temp_f);
-      tft.printf("Wind: %d mph %s\n", wind_mph, wind_dir);
-      tft.printf("Sunrise: %s\n", sunrise);
-      tft.printf("Sunset: %s\n", sunset);
-      tft.printf("Fishing Score: %d\n", score);
-      tft.printf("Rating: %s\n", fishRate.c_str());
-      
-      rectMeter(score);
-      tft.println();
-      tft.println();
-
-    } else {
-      Serial.printf("HTTP GET failed, code: %d\n", httpCode);
-      tft.fillScreen(TFT_BLACK);
-      tft.setCursor(10, 10);
-      tft.printf("HTTP error %d\n", httpCode);
+// Fetches every location whose cached record is missing or stale,
+// concurrently; each is drawn as soon as it and the ones above it are in.
+// The loop task waits here until the last one is in. That costs nothing
+// while loop() only sleeps until the next poll, and each request gives up
+// after its read timeouts. Anything added to loop() that must keep running
+// through a slow fetch needs this moved onto a task of its own first.
+void refreshWeather() {
+  time_t now = time(nullptr);
+  // Needs only the clock, and is a no-op until the local date changes
+  for (uint8_t i = 0; i < locationCount; ++i) {
+    solunarToday(solunar[i], locationPoints[i], now);
+    sunToday(sun[i], locationPoints[i], now);
+  }
+  if (WiFi.status() != WL_CONNECTED) return;
+
+  cachedMask = 0;
+  staleMask = 0;
+  for (uint8_t i = 0; i < locationCount; ++i) {
+    WeatherCacheResult r = weatherCacheLookup(locations[i], samples[i], now);
+    if (r == WEATHER_CACHE_HIT) {
+      cachedMask |= 1UL << i;
+      codes[i] = 200;
+    } else if (r == WEATHER_CACHE_STALE) {
+      staleMask |= 1UL << i;
     }
+  }
+
+  uint32_t startTime = millis();
+  uint32_t heapBefore = ESP.getFreeHeap();
+  fetchWeatherAll(locations, locationCount, samples, hourly, codes, cachedMask, onWeatherReady, nullptr);
+  reportFinish();
+  LOG_INFO("%d locations fetched in %lu ms, heap used %d", (int)locationCount,
+           millis() - startTime, (int)(heapBefore - ESP.getFreeHeap()));
+  WeatherCacheStats cs = weatherCacheStats();
+  LOG_INFO("weather cache: %lu hits, %lu stale, %lu misses, %lu writes", cs.hits, cs.stale,
+           cs.misses, cs.writes);
+}
 
-    http.end();
+// Oldest provider observation among the records held, 0 if none. Stale
+// records kept after a failed fetch count, so the retry comes soon.
+static uint32_t oldestUpdate() {
+  uint32_t oldest = 0;
+  for (uint8_t i = 0; i < locationCount; ++i) {
+    if (sampleHasError(samples[i]) || samples[i].updatedEpoch == 0) continue;
+    if (oldest == 0 || samples[i].updatedEpoch < oldest) oldest = samples[i].updatedEpoch;
   }
-  
+  return oldest;
 }
 
 void setup() {
-  Serial.begin(9600);
+  logBegin(115200);
   tftInit();
+  scoreInit();
+  weatherCacheBegin();
+  showCachedWeather();
   WiFi.begin(ssid, password);
   tft.println("Connecting to network");
   while (WiFi.status() != WL_CONNECTED) {
@@ -208,23 +185,33 @@ void setup() {
     tft.print(".");
   }
   tft.println("\n Connected!");
+  // The cache works in UTC, the moon in the local day; give SNTP a moment
+  // so fresh records count
+  configTzTime(LOCAL_TZ, "pool.ntp.org");
+  uint32_t ntpStart = millis();
+  while (!clockValid(time(nullptr)) && millis() - ntpStart < 3000) {
+    delay(100);
+  }
+  fetchPoolInit(WEATHER_HOST, WEATHER_PORT, API_KEY);
   if (!SD.begin(15)) {
     tft.println("SD Card Failed");
+  } else {
+    scoreLoadConfig();
   }
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0,10);
-  fetchWeather(location_Lincoln);
-  fetchWeather(location_Omaha);
-  drawBmp("/catfish.bmp", 60, 320);
+  refreshWeather();
+  setColorKey(FISH_COLOR_KEY);
+  drawImage("/catfish.bmp", 60, 320);
+  clearColorKey();
+  pollPlan(time(nullptr), oldestUpdate());
 }
 
 void loop() {
-  delay(3600000);
-  tft.fillScreen(TFT_BLACK);
-  tft.setCursor(0,10);
-  fetchWeather(location_Lincoln);
-  fetchWeather(location_Omaha);
-  drawBmp("/fish.bmp", 60, 320);
+  pollWait();
+  refreshWeather();
+  setColorKey(FISH_COLOR_KEY);
+  drawImage("/fish.bmp", 60, 320);
+  clearColorKey();
+  pollPlan(time(nullptr), oldestUpdate());
 }
 
 
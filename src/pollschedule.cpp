@@ -0,0 +1,44 @@
+#include <Arduino.h>
+#include "pollschedule.h"
+#include "timesync.h"
+#include "log.h"
+
+static uint32_t dueMs = 0;
+static bool planned = false;
+// Consecutive refreshes that found the provider had not published yet
+static uint8_t lateStreak = 0;
+
+void pollPlan(time_t now, uint32_t oldestEpoch) {
+  uint32_t nowMs = millis();
+  if (!clockValid(now) || oldestEpoch == 0) {
+    // Nothing to predict from: keep a fixed period off the last deadline
+    dueMs = planned ? dueMs + POLL_MAX_S * 1000UL : nowMs + POLL_MAX_S * 1000UL;
+    if ((int32_t)(dueMs - nowMs) < 0) dueMs = nowMs;
+    planned = true;
+    LOG_INFO("next refresh in %lu s (no provider time)", (dueMs - nowMs) / 1000);
+    return;
+  }
+
+  long waitS;
+  time_t expected = (time_t)oldestEpoch + POLL_PROVIDER_CADENCE_S + POLL_MARGIN_S;
+  if (expected > now) {
+    lateStreak = 0;
+    waitS = expected - now;
+  } else {
+    // The update we planned for has not shown up; back off
+    waitS = min((long)POLL_RETRY_S << min((int)lateStreak, 8), (long)POLL_PROVIDER_CADENCE_S);
+    if (lateStreak < 255) lateStreak++;
+  }
+  waitS = min(waitS, (long)POLL_MAX_S);
+  dueMs = nowMs + (uint32_t)waitS * 1000UL;
+  planned = true;
+  LOG_INFO("next refresh in %ld s (data %ld s old, %d late)", waitS, (long)(now - oldestEpoch),
+           (int)lateStreak);
+}
+
+void pollWait() {
+  int32_t left;
+  while ((left = (int32_t)(dueMs - millis())) > 0) {
+    vTaskDelay(pdMS_TO_TICKS(min(left, (int32_t)60000)));
+  }
+}
@@ -0,0 +1,25 @@
+#ifndef POLLSCHEDULE_H
+#define POLLSCHEDULE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+// How often WeatherAPI publishes new current conditions, and how long after
+// a predicted update to ask for it
+#define POLL_PROVIDER_CADENCE_S (15 * 60)
+#define POLL_MARGIN_S 60
+// First retry when the provider is late; doubles while it stays late, up
+// to one cadence
+#define POLL_RETRY_S 60
+// Longest gap between refreshes, also the fixed period used without a clock
+#define POLL_MAX_S 3600
+
+// Plans the next refresh after one that finished at `now`, from the oldest
+// provider timestamp now on screen (0 if unknown). Deadlines are absolute,
+// so time spent fetching and drawing does not push later refreshes back.
+void pollPlan(time_t now, uint32_t oldestEpoch);
+
+// Blocks until the planned deadline; returns at once if it has passed
+void pollWait();
+
+#endif
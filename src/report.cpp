@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "report.h"
+#include "log.h"
+#include "astro.h"
+#include "scoremodel.h"
+#include "weathercache.h"
+#include "weatherclient.h"
+
+extern TFT_eSPI tft;
+
+// Where the last report ended; the whole screen until one is drawn
+static int16_t reportBottom;
+
+// Report text goes through here: each line is blanked to the right edge as
+// it ends, so a refresh can draw over the last report without clearing the
+// screen first
+class ReportPrint : public Print {
+public:
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (c == '\n') {
+      int16_t x = tft.getCursorX();
+      tft.fillRect(x, tft.getCursorY(), tft.width() - x, tft.fontHeight(), TFT_BLACK);
+    }
+    return tft.write(c);
+  }
+};
+
+static ReportPrint report;
+
+void reportInit() {
+  reportBottom = tft.height();
+}
+
+void reportRestart() {
+  tft.setCursor(0, 10);
+}
+
+void reportFinish() {
+  int16_t bottom = tft.getCursorY();
+  if (bottom < reportBottom) {
+    tft.fillRect(0, bottom, tft.width(), reportBottom - bottom, TFT_BLACK);
+  }
+  reportBottom = bottom;
+}
+
+void rectMeter(int fishScore){
+  int16_t y;
+  y = tft.getCursorY();
+  int barWidth = map(fishScore, 0, 100, 0, tft.width() - 20);
+
+  uint16_t color = TFT_RED;
+  if (fishScore >= 80) {
+        color = TFT_GREEN;
+      } else if (fishScore >= 60) {
+        color = TFT_YELLOW;
+      } else if (fishScore >= 40) {
+        color = TFT_ORANGE;
+      }
+  // The two text rows the meter sits in, around and behind the bar
+  int16_t w = tft.width();
+  int16_t rows = 2 * tft.fontHeight();
+  tft.fillRect(0, y, w, 10, TFT_BLACK);
+  tft.fillRect(0, y+30, w, rows-30, TFT_BLACK);
+  tft.fillRect(0, y+10, 10, 20, TFT_BLACK);
+  tft.fillRect(w-10, y+10, 10, 20, TFT_BLACK);
+  tft.fillRect(10, y+10, barWidth, 20, color);
+  tft.fillRect(10+barWidth, y+10, w-20-barWidth, 20, TFT_BLACK);
+  tft.drawRect(10, y+10, w-20, 20, TFT_WHITE);
+}
+
+const char *fishRating(int score) {
+  if (score >= 80) return "Excellent";
+  if (score >= 60) return "Good";
+  if (score >= 40) return "Fair";
+  return "Poor";
+}
+
+// "Best: Tue 6AM (82)" for the highest-scoring run of hours still ahead,
+// one line per species; nothing when there is no forecast, as for a cached
+// report. All the species are scored in one pass over shared indices.
+static void showBestWindow(const HourlyForecast &f, uint8_t speciesMask, time_t now) {
+  static ScoreIndices idx;
+  static uint8_t scores[SPECIES_COUNT][FORECAST_HOURS];
+  int from = forecastSlot(f, now);
+  if (f.hours == 0 || from < 0) return;
+
+  const ScoreTables *tables[SPECIES_COUNT];
+  uint8_t picked[SPECIES_COUNT];
+  uint8_t k = 0;
+  for (uint8_t s = 0; s < SPECIES_COUNT; ++s) {
+    if (!(speciesMask & SPECIES_BIT(s))) continue;
+    tables[k] = &scoreTables(s);
+    picked[k++] = s;
+  }
+  scoreIndices(f, idx);
+  scoreMatrix(idx, tables, k, scores);
+
+  for (uint8_t p = 0; p < k; ++p) {
+    uint16_t total;
+    int start = bestWindow(scores[p], f.hours, from, BEST_WINDOW_HOURS, total);
+    if (start < 0) continue;
+    char label[12];
+    slotLabel(f, start, label);
+    if (k > 1) report.printf("%s ", speciesLabel(picked[p]));
+    report.printf("Best: %s (%d)\n", label, total / BEST_WINDOW_HOURS);
+  }
+}
+
+// "Cat 70 | Bass 55": the current score under each species picked
+static void showSpeciesScores(const WeatherSample &w, uint8_t speciesMask, int8_t activity) {
+  const char *sep = "";
+  for (uint8_t s = 0; s < SPECIES_COUNT; ++s) {
+    if (!(speciesMask & SPECIES_BIT(s))) continue;
+    report.printf("%s%s %d", sep, speciesLabel(s), scoreSample(w, s, activity));
+    sep = " | ";
+  }
+  report.println();
+}
+
+// "Moon: Wax Gibb 78%" and the start of the major period under way or next
+static void showMoon(const SolunarDay &d, int minute) {
+  report.printf("Moon: %s %d%%\n", moonPhaseText(d.phase), d.illumination);
+  uint16_t major = solunarNextMajor(d, minute);
+  if (major != SAMPLE_NO_TIME) {
+    char text[9];
+    clockText(major, text);
+    report.printf("Major: %s\n", text);
+  }
+}
+
+void showWeather(const String &location, int httpCode, const WeatherSample &w,
+                 uint8_t speciesMask, const SolunarCache &solunar, time_t now,
+                 const HourlyForecast *forecast) {
+  if (httpCode == WEATHER_PARSE_FAILED) {
+    LOG_ERROR("weather parse failed for %s", location);
+    tft.fillScreen(TFT_BLACK);
+    tft.setCursor(10, 10);
+    tft.println("PARSE ERROR");
+    return;
+  }
+
+  if (httpCode > 0) {
+    // Handle WeatherAPI errors
+    if (sampleHasError(w)) {
+      const char* msg = weatherErrorText(w.apiError);
+      tft.fillScreen(TFT_BLACK);
+      tft.setCursor(10, 10);
+      tft.printf("API error: %s\n", msg);
+      return;
+    }
+
+    // The first species picked drives the rating and the meter
+    uint8_t lead = SPECIES_CATFISH;
+    while (lead < SPECIES_COUNT - 1 && !(speciesMask & SPECIES_BIT(lead))) lead++;
+    LocalDay today;
+    int minute = 0;
+    int8_t activity = SAMPLE_NO_PERCENT;
+    if (localDayOf(now, today)) {
+      minute = (now - today.midnightEpoch) / 60;
+      activity = solunarActivity(solunar, today.dayNumber, minute);
+    }
+    int score = scoreSample(w, lead, activity);
+    char sunrise[9], sunset[9];
+    clockText(w.sunriseMin, sunrise);
+    clockText(w.sunsetMin, sunset);
+
+    // Display on TFT
+    report.printf("Location: %s\n", location.c_str());
+    long age = weatherAge(w, now);
+    if (age >= 0) {
+      report.printf("Updated: %ld min ago\n", age / 60);
+    }
+    report.printf("Temp: %.1f F\n", sampleTempF(w));
+    report.printf("Wind: %d mph %s\n", (int)sampleWindMph(w), windDirText(w.windDir));
+    report.printf("Sunrise: %s\n", sunrise);
+    report.printf("Sunset: %s\n", sunset);
+    if (activity != SAMPLE_NO_PERCENT && solunar.firstDay == today.dayNumber) {
+      showMoon(solunar.days[0], minute);
+    }
+    if (speciesMask & (speciesMask - 1)) {
+      showSpeciesScores(w, speciesMask, activity);
+    } else {
+      report.printf("Fishing Score: %d\n", score);
+    }
+    report.printf("Rating: %s\n", fishRating(score));
+    if (forecast) showBestWindow(*forecast, speciesMask, now);
+    
+    rectMeter(score);
+    tft.println();
+    tft.println();
+
+  } else {
+    LOG_ERROR("HTTP GET failed, code: %d", httpCode);
+    tft.fillScreen(TFT_BLACK);
+    tft.setCursor(10, 10);
+    tft.printf("HTTP error %d\n", httpCode);
+  }
+}
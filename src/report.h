@@ -0,0 +1,36 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "weathersample.h"
+#include "forecast.h"
+#include "solunar.h"
+
+// The weather report: a block of text and a score meter per location,
+// drawn top to bottom over the previous report instead of clearing the
+// screen first. Error screens still clear it.
+
+// Hours of the best-window search shown under each report
+#ifndef BEST_WINDOW_HOURS
+#define BEST_WINDOW_HOURS 3
+#endif
+
+// After tft.init(): the whole screen counts as the last report
+void reportInit();
+// Moves to the top for the first location of a new report
+void reportRestart();
+// Clears whatever of the previous report ran past the one just drawn
+void reportFinish();
+
+// One location's block. httpCode is what fetchWeatherAll() reported for
+// it; `now` places the moon, the record's age and the best window.
+// Without a forecast, as for a cached record, there is no best window.
+void showWeather(const String &location, int httpCode, const WeatherSample &w,
+                 uint8_t speciesMask, const SolunarCache &solunar, time_t now,
+                 const HourlyForecast *forecast = nullptr);
+// Score bar across the two text rows at the cursor, red to green
+void rectMeter(int fishScore);
+const char *fishRating(int score);
+
+#endif
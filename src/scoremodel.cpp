@@ -0,0 +1,230 @@
+#include <Arduino.h>
+#include <SD.h>
+#include "scoremodel.h"
+#include "log.h"
+
+#define SCORE_OPEN 1e9
+
+static const char *const factorNames[FACTOR_COUNT] = {
+  "cloud", "wind", "pressure", "temp", "rain", "solunar"
+};
+
+// Thresholds as the report has always applied them. Temperature keeps its
+// historical quirk: the 50-85 F fallback band matches every value, so
+// anything outside 60-75 F scores 10 and the 5-point case never happens.
+// Solunar activity only adds: nothing when it is unknown or quiet, so
+// reports without it score as they always have.
+constexpr ScoreModel defaultScoreModel = {{
+  { 2, { { 80, SCORE_OPEN, 20 }, { 50, SCORE_OPEN, 10 } }, 5 },        // cloud %
+  { 2, { { -SCORE_OPEN, 10, 20 }, { -SCORE_OPEN, 20, 10 } }, 5 },      // wind mph
+  { 2, { { 29.8, 30.2, 20 }, { -SCORE_OPEN, 29.6, 5 } }, 0 },          // pressure inHg
+  { 1, { { 60, 75, 20 } }, 10 },                                       // temp F
+  { 2, { { 0, 30, 20 }, { 61, SCORE_OPEN, 5 } }, 0 },                  // rain %
+  { 2, { { 70, 100, 10 }, { 40, 69, 5 } }, 0 },                        // solunar
+}};
+
+// Bass want warmer, clearer water than catfish and bite best with some
+// chop on the surface
+constexpr ScoreModel bassScoreModel = {{
+  { 2, { { 40, SCORE_OPEN, 20 }, { 15, SCORE_OPEN, 10 } }, 5 },        // cloud %
+  { 2, { { 5, 15, 20 }, { -SCORE_OPEN, 20, 10 } }, 5 },                // wind mph
+  { 2, { { 29.9, 30.2, 20 }, { 29.6, 30.5, 10 } }, 5 },                // pressure inHg
+  { 2, { { 65, 80, 20 }, { 55, 85, 10 } }, 5 },                        // temp F
+  { 2, { { 0, 40, 20 }, { 41, 70, 10 } }, 5 },                         // rain %
+  { 2, { { 70, 100, 10 }, { 40, 69, 5 } }, 0 },                        // solunar
+}};
+
+struct SpeciesInfo {
+  const char *name; // config file suffix
+  const char *label;
+  const ScoreModel *defaults;
+};
+
+static const SpeciesInfo species[SPECIES_COUNT] = {
+  { "catfish", "Cat", &defaultScoreModel },
+  { "bass", "Bass", &bassScoreModel },
+};
+
+static ScoreModel activeModels[SPECIES_COUNT];
+static ScoreTables activeTables[SPECIES_COUNT];
+
+static uint8_t bandPoints(const FactorModel &f, double v) {
+  for (uint8_t i = 0; i < f.bandCount; ++i) {
+    if (v >= f.bands[i].lo && v <= f.bands[i].hi) return f.bands[i].points;
+  }
+  return f.otherwise;
+}
+
+// Each slot is scored from the value the report would have compared: the
+// integer as-is, or the float that the quantized reading dequantizes to
+void scoreBuildTables(const ScoreModel &m, ScoreTables &t) {
+  for (int i = 0; i < SCORE_PERCENT_SLOTS; ++i) {
+    t.cloud[i] = bandPoints(m.factors[FACTOR_CLOUD], SCORE_PERCENT_MIN + i);
+    t.rain[i] = bandPoints(m.factors[FACTOR_RAIN], SCORE_PERCENT_MIN + i);
+    t.solunar[i] = bandPoints(m.factors[FACTOR_SOLUNAR], SCORE_PERCENT_MIN + i);
+  }
+  for (int i = 0; i < SCORE_WIND_SLOTS; ++i) {
+    t.wind[i] = bandPoints(m.factors[FACTOR_WIND], SCORE_WIND_MIN + i);
+  }
+  for (int i = 0; i < SCORE_PRESSURE_SLOTS; ++i) {
+    float p = (float)((SCORE_PRESSURE_MIN + i) / 100.0);
+    t.pressure[i] = bandPoints(m.factors[FACTOR_PRESSURE], p);
+  }
+  for (int i = 0; i < SCORE_TEMP_SLOTS; ++i) {
+    float f = (float)((SCORE_TEMP_MIN + i) / 10.0);
+    t.temp[i] = bandPoints(m.factors[FACTOR_TEMP], f);
+  }
+}
+
+void scoreIndices(const HourlyForecast &f, ScoreIndices &idx) {
+  for (int i = 0; i < FORECAST_HOURS; ++i) idx.cloud[i] = scorePercentIndex(f.cloud[i]);
+  for (int i = 0; i < FORECAST_HOURS; ++i) idx.wind[i] = scoreWindIndex(f.windDeciMph[i]);
+  for (int i = 0; i < FORECAST_HOURS; ++i) {
+    idx.pressure[i] = scorePressureIndex(f.pressureCentiIn[i]);
+  }
+  for (int i = 0; i < FORECAST_HOURS; ++i) idx.temp[i] = scoreTempIndex(f.tempDeciF[i]);
+  for (int i = 0; i < FORECAST_HOURS; ++i) idx.rain[i] = scorePercentIndex(f.rainChance[i]);
+  for (int i = 0; i < FORECAST_HOURS; ++i) idx.solunar[i] = scorePercentIndex(f.solunar[i]);
+}
+
+void scoreMatrix(const ScoreIndices &idx, const ScoreTables *const *tables, uint8_t k,
+                 uint8_t (*scores)[FORECAST_HOURS]) {
+  for (uint8_t p = 0; p < k; ++p) {
+    const ScoreTables &t = *tables[p];
+    // Six factors of up to SCORE_MAX each would wrap a uint8_t
+    uint16_t sum[FORECAST_HOURS];
+    for (int i = 0; i < FORECAST_HOURS; ++i) sum[i] = t.cloud[idx.cloud[i]];
+    for (int i = 0; i < FORECAST_HOURS; ++i) sum[i] += t.wind[idx.wind[i]];
+    for (int i = 0; i < FORECAST_HOURS; ++i) sum[i] += t.pressure[idx.pressure[i]];
+    for (int i = 0; i < FORECAST_HOURS; ++i) sum[i] += t.temp[idx.temp[i]];
+    for (int i = 0; i < FORECAST_HOURS; ++i) sum[i] += t.rain[idx.rain[i]];
+    uint8_t *out = scores[p];
+    for (int i = 0; i < FORECAST_HOURS; ++i) {
+      out[i] = scoreCap(sum[i] + t.solunar[idx.solunar[i]]);
+    }
+  }
+}
+
+static int factorByName(const char *name) {
+  for (uint8_t i = 0; i < FACTOR_COUNT; ++i) {
+    if (strcmp(name, factorNames[i]) == 0) return i;
+  }
+  return -1;
+}
+
+// A whole token as a number, "inf" and "-inf" included
+static bool parseBound(const char *text, double &out) {
+  char *end;
+  out = strtod(text, &end);
+  return end != text && *end == '\0';
+}
+
+static bool parsePoints(const char *text, uint8_t &out) {
+  char *end;
+  long v = strtol(text, &end, 10);
+  if (end == text || *end != '\0' || v < 0 || v > SCORE_MAX) return false;
+  out = (uint8_t)v;
+  return true;
+}
+
+// One config line into `m`; `seen` tracks factors whose compiled-in bands
+// have already been dropped
+static bool applyLine(char *line, ScoreModel &m, uint8_t &seen) {
+  char *hash = strchr(line, '#');
+  if (hash) *hash = '\0';
+  char *name = strtok(line, " \t\r");
+  if (!name) return true;
+  int f = factorByName(name);
+  if (f < 0) return false;
+  FactorModel &factor = m.factors[f];
+  if (!(seen & (1 << f))) {
+    factor.bandCount = 0;
+    seen |= 1 << f;
+  }
+
+  char *a = strtok(nullptr, " \t\r");
+  char *b = strtok(nullptr, " \t\r");
+  char *c = strtok(nullptr, " \t\r");
+  char *extra = strtok(nullptr, " \t\r");
+  if (a && strcmp(a, "default") == 0) {
+    return b && !c && parsePoints(b, factor.otherwise);
+  }
+  if (!c || extra || factor.bandCount == SCORE_MAX_BANDS) return false;
+  ScoreBand band;
+  // Written so that a NaN bound fails too
+  if (!parseBound(a, band.lo) || !parseBound(b, band.hi) || !(band.lo <= band.hi) ||
+      !parsePoints(c, band.points)) {
+    return false;
+  }
+  factor.bands[factor.bandCount++] = band;
+  return true;
+}
+
+bool scoreModelLoad(const char *path, ScoreModel &model) {
+  fs::File file = SD.open(path);
+  if (!file) return false;
+
+  ScoreModel m = model;
+  uint8_t seen = 0;
+  char line[64];
+  int lineNo = 0;
+  bool ok = true;
+  bool tooLong = false;
+  while (ok && file.available()) {
+    size_t n = 0;
+    int c;
+    while ((c = file.read()) >= 0 && c != '\n') {
+      if (n + 1 < sizeof line) {
+        line[n++] = c;
+      } else {
+        tooLong = true;
+      }
+    }
+    line[n] = '\0';
+    lineNo++;
+    ok = !tooLong && applyLine(line, m, seen);
+  }
+  file.close();
+  if (tooLong) {
+    LOG_ERROR("%s line %d is over %d characters", path, lineNo, (int)sizeof line - 1);
+    return false;
+  }
+  if (!ok) {
+    LOG_ERROR("%s line %d not understood", path, lineNo);
+    return false;
+  }
+  model = m;
+  return true;
+}
+
+void scoreInit() {
+  for (uint8_t i = 0; i < SPECIES_COUNT; ++i) {
+    activeModels[i] = *species[i].defaults;
+    scoreBuildTables(activeModels[i], activeTables[i]);
+  }
+}
+
+bool scoreLoadConfig() {
+  bool any = false;
+  for (uint8_t i = 0; i < SPECIES_COUNT; ++i) {
+    char path[32];
+    if (i == SPECIES_CATFISH) {
+      snprintf(path, sizeof path, "%s", SCORE_CONFIG_PATH);
+    } else {
+      snprintf(path, sizeof path, "/score-%s.cfg", species[i].name);
+    }
+    if (!scoreModelLoad(path, activeModels[i])) continue;
+    scoreBuildTables(activeModels[i], activeTables[i]);
+    LOG_INFO("%s score bands loaded from %s", species[i].name, path);
+    any = true;
+  }
+  return any;
+}
+
+const ScoreTables &scoreTables(uint8_t s) {
+  return activeTables[s < SPECIES_COUNT ? s : (uint8_t)SPECIES_CATFISH];
+}
+
+const char *speciesLabel(uint8_t s) {
+  return species[s < SPECIES_COUNT ? s : (uint8_t)SPECIES_CATFISH].label;
+}
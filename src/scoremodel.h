@@ -0,0 +1,159 @@
+#ifndef SCOREMODEL_H
+#define SCOREMODEL_H
+
+#include <Arduino.h>
+#include "weathersample.h"
+#include "forecast.h"
+
+#define SCORE_MAX_BANDS 4
+// Factor points add up past this only through the solunar bonus; the total
+// is capped here
+#define SCORE_MAX 100
+// Optional overrides of the compiled-in bands, read from the SD card: this
+// file for catfish, "/score-<species>.cfg" for the others
+#define SCORE_CONFIG_PATH "/score.cfg"
+
+// Points for values in [lo, hi], both inclusive, compared in the units the
+// report shows (percent, whole mph, inHg, F; solunar activity 0-100). Bands are tried in order and
+// the first match wins; a factor's `otherwise` covers everything else.
+struct ScoreBand {
+  double lo;
+  double hi;
+  uint8_t points;
+};
+
+enum ScoreFactor : uint8_t {
+  FACTOR_CLOUD,
+  FACTOR_WIND,
+  FACTOR_PRESSURE,
+  FACTOR_TEMP,
+  FACTOR_RAIN,
+  FACTOR_SOLUNAR,
+  FACTOR_COUNT
+};
+
+struct FactorModel {
+  uint8_t bandCount;
+  ScoreBand bands[SCORE_MAX_BANDS];
+  uint8_t otherwise;
+};
+
+struct ScoreModel {
+  FactorModel factors[FACTOR_COUNT];
+};
+
+// Profiles scored side by side; a location picks any of them by bit
+enum ScoreSpecies : uint8_t {
+  SPECIES_CATFISH,
+  SPECIES_BASS,
+  SPECIES_COUNT
+};
+#define SPECIES_BIT(s) (1u << (s))
+
+// Quantized input domains of the lookup tables. Inputs outside are clamped
+// to the nearest end, so bands should sit inside them.
+#define SCORE_PERCENT_MIN -1 // the missing-value sentinel
+#define SCORE_PERCENT_MAX 100
+#define SCORE_WIND_MIN -1 // whole mph
+#define SCORE_WIND_MAX 100
+#define SCORE_PRESSURE_MIN 2700 // 0.01 inHg
+#define SCORE_PRESSURE_MAX 3300
+#define SCORE_TEMP_MIN 0 // 0.1 F
+#define SCORE_TEMP_MAX 1200
+
+#define SCORE_PERCENT_SLOTS (SCORE_PERCENT_MAX - SCORE_PERCENT_MIN + 1)
+#define SCORE_WIND_SLOTS (SCORE_WIND_MAX - SCORE_WIND_MIN + 1)
+#define SCORE_PRESSURE_SLOTS (SCORE_PRESSURE_MAX - SCORE_PRESSURE_MIN + 1)
+#define SCORE_TEMP_SLOTS (SCORE_TEMP_MAX - SCORE_TEMP_MIN + 1)
+
+// A model flattened to one points table per factor over its quantized
+// domain, so a score is six loads and five adds (about 2.2 KB)
+struct ScoreTables {
+  uint8_t cloud[SCORE_PERCENT_SLOTS];
+  uint8_t wind[SCORE_WIND_SLOTS];
+  uint8_t pressure[SCORE_PRESSURE_SLOTS];
+  uint8_t temp[SCORE_TEMP_SLOTS];
+  uint8_t rain[SCORE_PERCENT_SLOTS];
+  uint8_t solunar[SCORE_PERCENT_SLOTS];
+};
+
+// The original hand-tuned profile, which is the catfish one
+extern const ScoreModel defaultScoreModel;
+extern const ScoreModel bassScoreModel;
+
+void scoreBuildTables(const ScoreModel &model, ScoreTables &out);
+
+// Replaces the bands of every factor named in the file, leaving the others
+// as they are in `model`. Lines are "<factor> <lo> <hi> <points>" or
+// "<factor> default <points>", factors being cloud, wind, pressure, temp,
+// rain and solunar; "inf" and "-inf" leave a band open. '#' starts a comment. Points
+// are whole numbers from 0 to SCORE_MAX and lo may not exceed hi. False if the file
+// is missing, has a line over 63 characters or an unreadable one (model left
+// untouched).
+bool scoreModelLoad(const char *path, ScoreModel &model);
+
+// Table indices from quantized inputs
+inline uint16_t scoreClamp(int v, int lo, int hi) {
+  return (uint16_t)((v < lo ? lo : v > hi ? hi : v) - lo);
+}
+inline uint16_t scorePercentIndex(int8_t pct) {
+  return scoreClamp(pct, SCORE_PERCENT_MIN, SCORE_PERCENT_MAX);
+}
+// Wind is scored in whole mph, truncated toward zero
+inline uint16_t scoreWindIndex(int16_t deciMph) {
+  return scoreClamp(deciMph / 10, SCORE_WIND_MIN, SCORE_WIND_MAX);
+}
+inline uint16_t scorePressureIndex(int16_t centiIn) {
+  return scoreClamp(centiIn, SCORE_PRESSURE_MIN, SCORE_PRESSURE_MAX);
+}
+inline uint16_t scoreTempIndex(int16_t deciF) {
+  return scoreClamp(deciF, SCORE_TEMP_MIN, SCORE_TEMP_MAX);
+}
+
+inline int scoreCap(int points) {
+  return points < SCORE_MAX ? points : SCORE_MAX;
+}
+
+// `solunar` is the activity at the sample's time (see solunar.h), or
+// SAMPLE_NO_PERCENT when it is not known
+inline int scoreWith(const ScoreTables &t, const WeatherSample &s,
+                     int8_t solunar = SAMPLE_NO_PERCENT) {
+  return scoreCap(t.cloud[scorePercentIndex(s.cloud)] + t.wind[scoreWindIndex(s.windDeciMph)] +
+                  t.pressure[scorePressureIndex(s.pressureCentiIn)] +
+                  t.temp[scoreTempIndex(s.tempDeciF)] + t.rain[scorePercentIndex(s.rainChance)] +
+                  t.solunar[scorePercentIndex(solunar)]);
+}
+
+// Table indices of every slot of a forecast, worked out once and shared by
+// every profile scored against it (864 B)
+struct ScoreIndices {
+  uint16_t cloud[FORECAST_HOURS];
+  uint16_t wind[FORECAST_HOURS];
+  uint16_t pressure[FORECAST_HOURS];
+  uint16_t temp[FORECAST_HOURS];
+  uint16_t rain[FORECAST_HOURS];
+  uint16_t solunar[FORECAST_HOURS];
+};
+
+void scoreIndices(const HourlyForecast &f, ScoreIndices &idx);
+
+// Scores the slots of one forecast under `k` profiles into scores[profile][slot].
+// Each factor is one straight pass of loads over its index array, with no
+// branches and nothing allocated. Slots past a forecast's `hours` score its
+// missing-value sentinels.
+void scoreMatrix(const ScoreIndices &idx, const ScoreTables *const *tables, uint8_t k,
+                 uint8_t (*scores)[FORECAST_HOURS]);
+
+// The active profiles: built-in bands until scoreLoadConfig() finds overrides
+void scoreInit();
+bool scoreLoadConfig();
+const ScoreTables &scoreTables(uint8_t species = SPECIES_CATFISH);
+// Short name for the report, e.g. "Bass"
+const char *speciesLabel(uint8_t species);
+
+inline int scoreSample(const WeatherSample &s, uint8_t species = SPECIES_CATFISH,
+                       int8_t solunar = SAMPLE_NO_PERCENT) {
+  return scoreWith(scoreTables(species), s, solunar);
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include <Arduino.h>
+#include "solunar.h"
+#include "log.h"
+
+#define SYNODIC_MONTH 29.530589
+
+struct MoonAt {
+  Equatorial eq;
+  double parallax; // horizontal parallax, degrees
+  double lon;      // ecliptic longitude, degrees
+};
+
+// Low-precision lunar position from the Astronomical Almanac: the six
+// largest longitude terms and four each for latitude and parallax
+static MoonAt moonAt(double days) {
+  double t = days / 36525.0;
+  double m1 = 135.0 + 477198.87 * t;
+  double m2 = 259.3 - 413335.36 * t;
+  double m3 = 235.7 + 890534.22 * t;
+  double m4 = 269.9 + 954397.74 * t;
+  double lon = 218.32 + 481267.881 * t + 6.29 * astroSin(m1) - 1.27 * astroSin(m2) +
+               0.66 * astroSin(m3) + 0.21 * astroSin(m4) - 0.19 * astroSin(357.5 + 35999.05 * t) -
+               0.11 * astroSin(186.5 + 966404.03 * t);
+  double lat = 5.13 * astroSin(93.3 + 483202.02 * t) + 0.28 * astroSin(228.2 + 960400.89 * t) -
+               0.28 * astroSin(318.3 + 6003.15 * t) - 0.17 * astroSin(217.6 - 407332.21 * t);
+  MoonAt m;
+  m.parallax = 0.9508 + 0.0518 * astroCos(m1) + 0.0095 * astroCos(m2) + 0.0078 * astroCos(m3) +
+               0.0028 * astroCos(m4);
+  m.lon = astroWrap360(lon);
+  m.eq = astroFromEcliptic(days, m.lon, lat);
+  return m;
+}
+
+// Curves for astroCrossing(). Rise and set use the geocentric altitude
+// against 0.7275 parallax - 34' (parallax, refraction and semidiameter).
+static double moonAboveHorizon(void *ctx, double epoch) {
+  const GeoPoint &p = *(const GeoPoint *)ctx;
+  double d = astroDays(epoch);
+  MoonAt m = moonAt(d);
+  return astroAltitude(m.eq, p, d) - (0.7275 * m.parallax - 0.5667);
+}
+
+static double moonHourAngle(void *ctx, double epoch) {
+  const GeoPoint &p = *(const GeoPoint *)ctx;
+  double d = astroDays(epoch);
+  return astroHourAngle(moonAt(d).eq, p, d);
+}
+
+static double moonHourAngleBelow(void *ctx, double epoch) {
+  return astroWrap180(moonHourAngle(ctx, epoch) + 180);
+}
+
+void solunarCompute(const GeoPoint &p, const LocalDay &day, SolunarDay &out) {
+  void *ctx = (void *)&p;
+  out.dayNumber = day.dayNumber;
+  out.moonrise = astroCrossing(moonAboveHorizon, ctx, day, 1);
+  out.moonset = astroCrossing(moonAboveHorizon, ctx, day, -1);
+  out.transit = astroCrossing(moonHourAngle, ctx, day, 1);
+  out.underfoot = astroCrossing(moonHourAngleBelow, ctx, day, 1);
+
+  double noon = astroDays(day.midnightEpoch + 43200.0);
+  double elongation = astroWrap360(moonAt(noon).lon - astroSunLongitude(noon));
+  out.illumination = (uint8_t)((1 - astroCos(elongation)) * 50 + 0.5);
+  out.ageTenths = (uint16_t)(elongation / 360 * SYNODIC_MONTH * 10 + 0.5);
+  out.phase = (MoonPhase)((int)((elongation + 22.5) / 45) % 8);
+}
+
+const SolunarDay *solunarToday(SolunarCache &c, const GeoPoint &p, time_t now) {
+  LocalDay today;
+  if (!localDayOf(now, today)) return nullptr;
+  if (c.firstDay == today.dayNumber) return &c.days[0];
+
+  // Keep the days already worked out when the date only moves on
+  SolunarCache next;
+  next.firstDay = today.dayNumber;
+  for (int i = 0; i < FORECAST_DAYS; ++i) {
+    int old = today.dayNumber + i - c.firstDay;
+    if (c.firstDay != 0 && old >= 0 && old < FORECAST_DAYS) {
+      next.days[i] = c.days[old];
+    } else {
+      solunarCompute(p, localDayAfter(today, i), next.days[i]);
+    }
+  }
+  c = next;
+  LOG_DEBUG("solunar day %ld: moonrise %d, transit %d, illumination %d%%", (long)today.dayNumber,
+            c.days[0].moonrise, c.days[0].transit, c.days[0].illumination);
+  return &c.days[0];
+}
+
+static bool within(uint16_t event, int shift, int minute, int halfWidth) {
+  if (event == SAMPLE_NO_TIME) return false;
+  int off = minute - (event + shift);
+  return off >= -halfWidth && off <= halfWidth;
+}
+
+int8_t solunarActivity(const SolunarCache &c, int32_t dayNumber, int minute) {
+  int idx = dayNumber - c.firstDay;
+  if (c.firstDay == 0 || idx < 0 || idx >= FORECAST_DAYS) return SAMPLE_NO_PERCENT;
+
+  int period = 0;
+  for (int k = idx - 1; k <= idx + 1; ++k) {
+    if (k < 0 || k >= FORECAST_DAYS) continue;
+    const SolunarDay &d = c.days[k];
+    int shift = (k - idx) * 1440;
+    if (within(d.transit, shift, minute, SOLUNAR_MAJOR_MIN) ||
+        within(d.underfoot, shift, minute, SOLUNAR_MAJOR_MIN)) {
+      period = 80;
+    } else if (period == 0 && (within(d.moonrise, shift, minute, SOLUNAR_MINOR_MIN) ||
+                               within(d.moonset, shift, minute, SOLUNAR_MINOR_MIN))) {
+      period = 40;
+    }
+  }
+
+  // Full marks at new and full moon, none at the quarters
+  double halfCycles = c.days[idx].ageTenths / (SYNODIC_MONTH * 5);
+  double fromSyzygy = fabs(halfCycles - floor(halfCycles + 0.5));
+  int phase = (int)(20 * (1 - fromSyzygy / 0.25) + 0.5);
+  return period + (phase > 0 ? phase : 0);
+}
+
+void solunarFill(const SolunarCache &c, HourlyForecast &f) {
+  // startEpoch is local midnight, so half a day on is inside the local date
+  int32_t firstDay = (f.startEpoch + 43200UL) / 86400UL;
+  for (int slot = 0; slot < FORECAST_HOURS; ++slot) {
+    f.solunar[slot] = f.startEpoch == 0
+                          ? SAMPLE_NO_PERCENT
+                          : solunarActivity(c, firstDay + slot / 24, slot % 24 * 60 + 30);
+  }
+}
+
+uint16_t solunarNextMajor(const SolunarDay &d, int minute) {
+  uint16_t next = SAMPLE_NO_TIME;
+  const uint16_t centres[] = { d.transit, d.underfoot };
+  for (uint16_t centre : centres) {
+    if (centre == SAMPLE_NO_TIME || centre + SOLUNAR_MAJOR_MIN < minute) continue;
+    uint16_t start = centre > SOLUNAR_MAJOR_MIN ? centre - SOLUNAR_MAJOR_MIN : 0;
+    if (next == SAMPLE_NO_TIME || start < next) next = start;
+  }
+  return next;
+}
+
+const char *moonPhaseText(MoonPhase phase) {
+  static const char *const names[] = {
+    "New", "Wax Cresc", "1st Qtr", "Wax Gibb", "Full", "Wan Gibb", "3rd Qtr", "Wan Cresc"
+  };
+  return phase < 8 ? names[phase] : "?";
+}
@@ -0,0 +1,60 @@
+#ifndef SOLUNAR_H
+#define SOLUNAR_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "astro.h"
+#include "forecast.h"
+
+// Half-widths of the solunar periods: the majors around the moon's upper
+// and lower transits, the minors around moonrise and moonset
+#define SOLUNAR_MAJOR_MIN 60
+#define SOLUNAR_MINOR_MIN 30
+
+enum MoonPhase : uint8_t {
+  MOON_NEW, MOON_WAXING_CRESCENT, MOON_FIRST_QUARTER, MOON_WAXING_GIBBOUS,
+  MOON_FULL, MOON_WANING_GIBBOUS, MOON_LAST_QUARTER, MOON_WANING_CRESCENT
+};
+
+// The moon over one local day at one place. Times are minutes since local
+// midnight, SAMPLE_NO_TIME when the event does not happen that day.
+struct SolunarDay {
+  int32_t dayNumber;
+  uint16_t moonrise;
+  uint16_t transit;   // overhead, centre of a major period
+  uint16_t underfoot; // lower transit, the other major
+  uint16_t moonset;
+  uint8_t illumination; // percent lit at local noon
+  uint16_t ageTenths;   // days since new moon, 0.1 day
+  MoonPhase phase;
+};
+
+// A location's solunar days from today on, recomputed once the local date
+// moves past firstDay. A zeroed cache is empty.
+struct SolunarCache {
+  int32_t firstDay;
+  SolunarDay days[FORECAST_DAYS];
+};
+
+// Computes the moon for `day` from low-order series (about 0.3 degree,
+// a minute or two of rise and set time)
+void solunarCompute(const GeoPoint &p, const LocalDay &day, SolunarDay &out);
+
+// Brings `c` up to date for `now`; today's entry, or nullptr without a clock
+const SolunarDay *solunarToday(SolunarCache &c, const GeoPoint &p, time_t now);
+
+// 0-100: up to 80 inside a period (majors count more than minors) plus up
+// to 20 near new and full moon. SAMPLE_NO_PERCENT if `dayNumber` is not
+// in the cache. Periods from the neighbouring days spill over midnight.
+int8_t solunarActivity(const SolunarCache &c, int32_t dayNumber, int minute);
+
+// Fills f.solunar for every slot from the cached days
+void solunarFill(const SolunarCache &c, HourlyForecast &f);
+
+// Start of the major period under way at `minute` of today, else of the
+// next one today; SAMPLE_NO_TIME if none is left
+uint16_t solunarNextMajor(const SolunarDay &d, int minute);
+
+const char *moonPhaseText(MoonPhase phase);
+
+#endif
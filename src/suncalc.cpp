@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include "suncalc.h"
+#include "log.h"
+
+// Zenith angles of the events: the upper limb on the horizon after
+// refraction, and the centre 6 degrees down
+#define SUN_ZENITH_HORIZON 90.833
+#define SUN_ZENITH_CIVIL 96.0
+
+struct SolarAt {
+  double declination; // degrees
+  double eqTime;      // minutes, apparent minus mean solar time
+};
+
+// NOAA solar position, from Meeus via the NOAA spreadsheet
+static SolarAt solarAt(double epoch) {
+  double jc = astroDays(epoch) / 36525.0;
+  double l0 = astroWrap360(280.46646 + jc * (36000.76983 + jc * 0.0003032));
+  double m = 357.52911 + jc * (35999.05029 - 0.0001537 * jc);
+  double e = 0.016708634 - jc * (0.000042037 + 0.0000001267 * jc);
+  double c = astroSin(m) * (1.914602 - jc * (0.004817 + 0.000014 * jc)) +
+             astroSin(2 * m) * (0.019993 - 0.000101 * jc) + astroSin(3 * m) * 0.000289;
+  double omega = 125.04 - 1934.136 * jc;
+  double lambda = l0 + c - 0.00569 - 0.00478 * astroSin(omega);
+  double obliq = 23 + (26 + (21.448 - jc * (46.815 + jc * (0.00059 - jc * 0.001813))) / 60) / 60 +
+                 0.00256 * astroCos(omega);
+
+  SolarAt s;
+  s.declination = asin(astroSin(obliq) * astroSin(lambda)) * (180 / M_PI);
+  double y = tan(obliq / 2 * (M_PI / 180));
+  y *= y;
+  double eq = y * astroSin(2 * l0) - 2 * e * astroSin(m) + 4 * e * y * astroSin(m) * astroCos(2 * l0) -
+              0.5 * y * y * astroSin(4 * l0) - 1.25 * e * e * astroSin(2 * m);
+  s.eqTime = 4 * eq * (180 / M_PI);
+  return s;
+}
+
+// UTC epoch of the sun reaching `zenith`, rising (-1) or setting (+1), on
+// the UTC date of `noonEpoch`; negative if it never does
+static double solarEvent(const GeoPoint &p, double noonEpoch, double zenith, int side) {
+  double utcMidnight = floor(noonEpoch / 86400) * 86400;
+  double t = noonEpoch;
+  for (int pass = 0; pass < 2; ++pass) {
+    SolarAt s = solarAt(t);
+    double cosH = astroCos(zenith) / (astroCos(p.lat) * astroCos(s.declination)) -
+                  tan(p.lat * (M_PI / 180)) * tan(s.declination * (M_PI / 180));
+    if (cosH < -1 || cosH > 1) return -1;
+    double hourAngle = acos(cosH) * (180 / M_PI);
+    double minutes = 720 - 4 * p.lon - s.eqTime + side * 4 * hourAngle;
+    t = utcMidnight + minutes * 60;
+  }
+  return t;
+}
+
+static uint16_t localMinute(double epoch, const LocalDay &day) {
+  if (epoch < 0) return SAMPLE_NO_TIME;
+  double minute = floor((epoch - day.midnightEpoch) / 60 + 0.5);
+  return minute >= 0 && minute < 1440 ? (uint16_t)minute : SAMPLE_NO_TIME;
+}
+
+void sunCompute(const GeoPoint &p, const LocalDay &day, SunDay &out) {
+  // Local noon falls on the same UTC date as the local day for any offset
+  // within 12 hours
+  double noon = day.midnightEpoch + 43200.0;
+  out.dayNumber = day.dayNumber;
+  out.dawn = localMinute(solarEvent(p, noon, SUN_ZENITH_CIVIL, -1), day);
+  out.sunrise = localMinute(solarEvent(p, noon, SUN_ZENITH_HORIZON, -1), day);
+  out.sunset = localMinute(solarEvent(p, noon, SUN_ZENITH_HORIZON, 1), day);
+  out.dusk = localMinute(solarEvent(p, noon, SUN_ZENITH_CIVIL, 1), day);
+}
+
+const SunDay *sunToday(SunDay &sun, const GeoPoint &p, time_t now) {
+  LocalDay today;
+  if (!localDayOf(now, today)) return nullptr;
+  if (sun.dayNumber != today.dayNumber) {
+    sunCompute(p, today, sun);
+    LOG_DEBUG("sun day %ld: dawn %d, sunrise %d, sunset %d", (long)today.dayNumber, sun.dawn,
+              sun.sunrise, sun.sunset);
+  }
+  return &sun;
+}
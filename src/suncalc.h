@@ -0,0 +1,27 @@
+#ifndef SUNCALC_H
+#define SUNCALC_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "astro.h"
+
+// The sun over one local day at one place, in minutes since local
+// midnight; SAMPLE_NO_TIME when the sun does not cross that altitude (polar
+// day or night). Civil twilight is the sun 6 degrees below the horizon.
+struct SunDay {
+  int32_t dayNumber; // 0 until first computed
+  uint16_t dawn;     // civil twilight begins
+  uint16_t sunrise;
+  uint16_t sunset;
+  uint16_t dusk;     // civil twilight ends
+};
+
+// NOAA's solar calculator: the sun's declination and equation of time from
+// low-order series, each event refined once at its own time. Good to
+// about a minute between the polar circles.
+void sunCompute(const GeoPoint &p, const LocalDay &day, SunDay &out);
+
+// Recomputes `sun` once the local date has moved on; nullptr without a clock
+const SunDay *sunToday(SunDay &sun, const GeoPoint &p, time_t now);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <time.h>
+
+// Epochs before this (September 2020) mean SNTP has not set the clock yet:
+// it counts up from 0 at boot until then
+#define CLOCK_VALID_EPOCH 1600000000L
+
+inline bool clockValid(time_t now) {
+  return now >= CLOCK_VALID_EPOCH;
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include "weathercache.h"
+#include "timesync.h"
+#include "log.h"
+
+#define WEATHER_CACHE_NAMESPACE "wxcache"
+// Bump when WeatherSample changes layout so old records read as misses
+#define WEATHER_CACHE_VERSION 2
+#define WEATHER_CACHE_NAME_LEN 32
+
+struct CacheRecord {
+  uint16_t version;
+  uint16_t size;
+  char location[WEATHER_CACHE_NAME_LEN];
+  WeatherSample sample;
+};
+
+static Preferences prefs;
+static bool cacheOpen = false;
+static WeatherCacheStats stats;
+
+// NVS keys are at most 15 characters, so records are keyed by a hash of
+// the location and the full name is checked on load
+static void keyFor(const String &location, char key[12]) {
+  uint32_t h = 2166136261UL; // FNV-1a
+  for (const char *p = location.c_str(); *p; ++p) {
+    h = (h ^ (uint8_t)*p) * 16777619UL;
+  }
+  snprintf(key, 12, "w%08lx", (unsigned long)h);
+}
+
+void weatherCacheBegin() {
+  cacheOpen = prefs.begin(WEATHER_CACHE_NAMESPACE, false);
+  if (!cacheOpen) LOG_WARN("weather cache unavailable");
+}
+
+long weatherAge(const WeatherSample &w, time_t now) {
+  if (!clockValid(now) || w.updatedEpoch == 0) return -1;
+  return now > (time_t)w.updatedEpoch ? (long)(now - w.updatedEpoch) : 0;
+}
+
+WeatherCacheResult weatherCacheLookup(const String &location, WeatherSample &out, time_t now) {
+  char key[12];
+  keyFor(location, key);
+  CacheRecord rec;
+  if (!cacheOpen || prefs.getBytesLength(key) != sizeof rec ||
+      prefs.getBytes(key, &rec, sizeof rec) != sizeof rec ||
+      rec.version != WEATHER_CACHE_VERSION || rec.size != sizeof rec.sample ||
+      strncmp(rec.location, location.c_str(), sizeof rec.location) != 0) {
+    stats.misses++;
+    return WEATHER_CACHE_MISS;
+  }
+  out = rec.sample;
+  long age = weatherAge(out, now);
+  if (age < 0 || age >= WEATHER_CACHE_TTL_S) {
+    stats.stale++;
+    return WEATHER_CACHE_STALE;
+  }
+  stats.hits++;
+  return WEATHER_CACHE_HIT;
+}
+
+void weatherCacheStore(const String &location, const WeatherSample &w) {
+  if (!cacheOpen || sampleHasError(w) || location.length() >= WEATHER_CACHE_NAME_LEN) return;
+  char key[12];
+  keyFor(location, key);
+  CacheRecord rec;
+  if (prefs.getBytes(key, &rec, sizeof rec) == sizeof rec && rec.version == WEATHER_CACHE_VERSION &&
+      rec.sample.updatedEpoch == w.updatedEpoch && w.updatedEpoch != 0) {
+    return;
+  }
+  memset(&rec, 0, sizeof rec);
+  rec.version = WEATHER_CACHE_VERSION;
+  rec.size = sizeof rec.sample;
+  strncpy(rec.location, location.c_str(), sizeof rec.location - 1);
+  rec.sample = w;
+  if (prefs.putBytes(key, &rec, sizeof rec) == sizeof rec) {
+    stats.writes++;
+  } else {
+    LOG_WARN("weather cache write failed for %s", location);
+  }
+}
+
+WeatherCacheStats weatherCacheStats() {
+  return stats;
+}
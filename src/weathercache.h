@@ -0,0 +1,43 @@
+#ifndef WEATHERCACHE_H
+#define WEATHERCACHE_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "weathersample.h"
+
+// Age after which a cached record is refetched. WeatherAPI publishes new
+// current conditions about every 15 minutes.
+#ifndef WEATHER_CACHE_TTL_S
+#define WEATHER_CACHE_TTL_S (15 * 60)
+#endif
+
+enum WeatherCacheResult {
+  WEATHER_CACHE_MISS,  // nothing stored for the location
+  WEATHER_CACHE_STALE, // record loaded but older than the TTL, or no clock yet
+  WEATHER_CACHE_HIT    // record loaded and fresh
+};
+
+struct WeatherCacheStats {
+  uint32_t hits;
+  uint32_t stale;
+  uint32_t misses;
+  uint32_t writes;
+};
+
+// Samples persisted in NVS, one per location, so a reboot can draw
+// the last report before the network is up
+void weatherCacheBegin();
+
+// Loads the stored record for `location` into `out` unless it is a miss
+WeatherCacheResult weatherCacheLookup(const String &location, WeatherSample &out, time_t now);
+
+// Persists a good record. Skips the flash write when the provider's
+// timestamp has not moved since the stored copy.
+void weatherCacheStore(const String &location, const WeatherSample &w);
+
+// Seconds since the provider observed `w`, or -1 without a clock
+long weatherAge(const WeatherSample &w, time_t now);
+
+WeatherCacheStats weatherCacheStats();
+
+#endif
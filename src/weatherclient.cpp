@@ -0,0 +1,173 @@
+#include <Arduino.h>
+#include "weatherclient.h"
+#include "httpbody.h"
+#include "gzipstream.h"
+#include "log.h"
+
+static const char *responseHeaders[] = { "Transfer-Encoding", "Content-Encoding" };
+// Accept-Encoding with the inflater claimed
+static const char *acceptGzip = "gzip;q=1, identity;q=0.5";
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+// The core's own, for a request without it
+static const char *coreAcceptEncoding = "identity;q=1,chunked;q=0.1,*;q=0";
+#endif
+
+WeatherClient::WeatherClient(const char *host, uint16_t port, const char *apiKey)
+    : host(host), port(port), apiKey(apiKey), lastMs(0), lastWasReused(false),
+      lastWasGzipped(false) {}
+
+void WeatherClient::close() {
+  http.end();
+  socket.stop();
+}
+
+String WeatherClient::uriFor(const String &query) const {
+#if WEATHER_FORECAST
+  return String("/v1/forecast.json?key=") + apiKey + "&q=" + query + "&days=" + String(FORECAST_DAYS) +
+         "&aqi=no&alerts=no";
+#else
+  return String("/v1/current.json?key=") + apiKey + "&q=" + query + "&aqi=no";
+#endif
+}
+
+int WeatherClient::request(const String &uri, const String *postBody, BodyParser parse,
+                           void *ctx) {
+  http.setReuse(WEATHER_REUSE_CONNECTION);
+  http.useHTTP10(false);
+  if (!http.begin(socket, host, port, uri.c_str())) return HTTPC_ERROR_CONNECTION_REFUSED;
+  http.collectHeaders(responseHeaders, 2);
+  // The inflater is shared by every client and only held for the length of
+  // one response; if it is in use or cannot be allocated, ask for an
+  // uncompressed body instead of waiting.
+  GzipStream *gzip = nullptr;
+  if (WEATHER_GZIP) {
+    bool busy;
+    gzip = gzipClaim(busy);
+    if (!gzip) LOG_INFO("gzip skipped: inflater %s", busy ? "in use" : "out of memory");
+  }
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  // Replaces the core's own header, which ties identity with gzip. The
+  // value sticks to the HTTPClient, so a request without the inflater puts
+  // the core's back.
+  http.setAcceptEncoding(gzip ? acceptGzip : coreAcceptEncoding);
+#else
+  // Older cores always send their own line; this goes out as a second one
+  // and the server may still pick identity, as lastGzipped() shows
+  if (gzip) http.addHeader("Accept-Encoding", acceptGzip);
+#endif
+  lastWasGzipped = false;
+
+  int httpCode;
+  if (postBody) {
+    http.addHeader("Content-Type", "application/json");
+    httpCode = http.POST(*postBody);
+  } else {
+    httpCode = http.GET();
+  }
+  if (httpCode <= 0) {
+    if (gzip) gzipRelease();
+    return httpCode;
+  }
+
+  bool chunked = http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+  HttpBodyStream body(http.getStream(), chunked ? -1 : http.getSize(), chunked,
+                      WEATHER_BODY_TIMEOUT_MS);
+  bool parsed;
+  if (gzip && http.header("Content-Encoding").equalsIgnoreCase("gzip")) {
+    lastWasGzipped = true;
+    gzip->reset(body, WEATHER_BODY_TIMEOUT_MS);
+    parsed = parse(*gzip, ctx) && gzip->finish();
+    LOG_DEBUG("gzip body %lu bytes, inflated %lu", gzip->compressedBytes(), gzip->inflatedBytes());
+  } else {
+    parsed = parse(body, ctx);
+  }
+  if (gzip) gzipRelease();
+  // Read the rest so the next request starts on a clean status line
+  if (!parsed || !body.drain() || !WEATHER_REUSE_CONNECTION) {
+    close();
+  } else {
+    http.end();
+  }
+  return parsed ? httpCode : WEATHER_PARSE_FAILED;
+}
+
+// request() with one retry when a reused connection turns out to be dead
+int WeatherClient::exchange(const String &uri, const String *postBody, BodyParser parse,
+                            void *ctx) {
+  uint32_t start = millis();
+  lastWasReused = socket.connected();
+
+  int httpCode = request(uri, postBody, parse, ctx);
+  if (httpCode < 0 && httpCode != WEATHER_PARSE_FAILED && lastWasReused) {
+    // The server may have dropped an idle connection; retry once on a new one
+    LOG_DEBUG("stale connection, reconnecting (%d)", httpCode);
+    close();
+    lastWasReused = false;
+    httpCode = request(uri, postBody, parse, ctx);
+  }
+  lastMs = millis() - start;
+  return httpCode;
+}
+
+struct SingleRequest {
+  WeatherSample *out;
+  HourlyForecast *hourly;
+};
+
+static bool parseSingle(Stream &body, void *ctx) {
+  SingleRequest &req = *(SingleRequest *)ctx;
+  return parseWeather(body, *req.out, req.hourly);
+}
+
+int WeatherClient::fetch(const String &location, WeatherSample &out, HourlyForecast *hourly) {
+  SingleRequest req = { &out, hourly };
+  int httpCode = exchange(uriFor(location), nullptr, parseSingle, &req);
+  LOG_INFO("%s fetched in %lu ms (%s connection, %s)", location, lastMs,
+           lastWasReused ? "reused" : "new", lastWasGzipped ? "gzip" : "identity");
+  return httpCode;
+}
+
+struct BulkRequest {
+  WeatherSample *out;
+  HourlyForecast *hourly;
+  uint8_t count;
+  uint32_t found;
+  WeatherSample error;
+};
+
+static bool parseBulk(Stream &body, void *ctx) {
+  BulkRequest &req = *(BulkRequest *)ctx;
+  return parseWeatherBulk(body, req.out, req.hourly, req.count, req.found, req.error) >= 0;
+}
+
+// One POST for all locations, each tagged with its index as custom_id
+uint32_t WeatherClient::fetchBulk(const String *locations, uint8_t count, uint32_t want,
+                                  WeatherSample *out, HourlyForecast *hourly) {
+  if (count > WEATHER_MAX_BULK) return 0;
+  String body = "{\"locations\":[";
+  bool first = true;
+  for (uint8_t i = 0; i < count; ++i) {
+    if (!(want & (1UL << i))) continue;
+    if (!first) body += ",";
+    first = false;
+    body += "{\"q\":\"";
+    body += locations[i];
+    body += "\",\"custom_id\":\"";
+    body += String(i);
+    body += "\"}";
+  }
+  body += "]}";
+
+  BulkRequest req;
+  req.out = out;
+  req.hourly = hourly;
+  req.count = count;
+  req.found = 0;
+  int httpCode = exchange(uriFor("bulk"), &body, parseBulk, &req);
+  req.found &= want;
+  if (httpCode > 0 && sampleHasError(req.error)) {
+    LOG_WARN("bulk request refused: %d", (int)req.error.apiError);
+  }
+  LOG_INFO("bulk fetch of %d locations in %lu ms: %d", (int)count, lastMs, httpCode);
+  return httpCode == 200 ? req.found : 0;
+}
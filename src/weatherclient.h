@@ -0,0 +1,86 @@
+#ifndef WEATHERCLIENT_H
+#define WEATHERCLIENT_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include "weatherparse.h"
+
+// Point these at a local stand-in server (tools/weather_server.py) to
+// measure fetch latency without the real API
+#ifndef WEATHER_HOST
+#define WEATHER_HOST "api.weatherapi.com"
+#endif
+#ifndef WEATHER_PORT
+#define WEATHER_PORT 80
+#endif
+// 0 opens a fresh connection per request, for comparison
+#ifndef WEATHER_REUSE_CONNECTION
+#define WEATHER_REUSE_CONNECTION 1
+#endif
+// 0 skips the bulk request and always fetches location by location
+#ifndef WEATHER_BULK
+#define WEATHER_BULK 1
+#endif
+// 0 asks for uncompressed bodies
+#ifndef WEATHER_GZIP
+#define WEATHER_GZIP 1
+#endif
+// 0 asks the lighter current.json for conditions only: no hourly forecast
+// (so no best window) and no chance of rain. Sun times are computed on the
+// device either way.
+#ifndef WEATHER_FORECAST
+#define WEATHER_FORECAST 1
+#endif
+#define WEATHER_BODY_TIMEOUT_MS 5000
+
+// fetch() result when the status line arrived but the body would not parse.
+// Clear of HTTPClient's own negative error codes.
+#define WEATHER_PARSE_FAILED -100
+
+// One keep-alive HTTP/1.1 connection to the weather API, reused for every
+// request made through it. Each response body is read to its end so the socket is left
+// at the next status line; it is only reopened after an error or when the
+// server closes it.
+class WeatherClient {
+ public:
+  WeatherClient(const char *host, uint16_t port, const char *apiKey);
+
+  // HTTP status, an HTTPClient error (< 0), or WEATHER_PARSE_FAILED. `out`
+  // is filled whenever a body was parsed, error responses included, and
+  // `hourly` too unless it is null.
+  int fetch(const String &location, WeatherSample &out, HourlyForecast *hourly);
+
+  // Fetches the locations with a bit set in `want` using one bulk request.
+  // Returns a bit per location filled in out[] (and hourly[] if not null),
+  // or 0 if the bulk call failed outright.
+  uint32_t fetchBulk(const String *locations, uint8_t count, uint32_t want, WeatherSample *out,
+                     HourlyForecast *hourly);
+
+  // Drops the connection; the next fetch() reconnects
+  void close();
+
+  uint32_t lastFetchMs() const { return lastMs; }
+  bool lastReused() const { return lastWasReused; }
+  // Whether the last response body came gzip-encoded
+  bool lastGzipped() const { return lastWasGzipped; }
+
+ private:
+  // Reads one response body; false if it would not parse
+  typedef bool (*BodyParser)(Stream &body, void *ctx);
+
+  int exchange(const String &uri, const String *postBody, BodyParser parse, void *ctx);
+  int request(const String &uri, const String *postBody, BodyParser parse, void *ctx);
+  String uriFor(const String &query) const;
+
+  const char *host;
+  uint16_t port;
+  const char *apiKey;
+  WiFiClient socket;
+  HTTPClient http;
+  uint32_t lastMs;
+  bool lastWasReused;
+  bool lastWasGzipped;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include <Arduino.h>
+#include "weatherparse.h"
+#include "jsonscan.h"
+#include "log.h"
+
+#define WEATHER_TIMEOUT_MS 5000
+
+// Paths of interest as a trie; see JsonPathNode. Nodes below N_RECORD_END
+// describe one location's record hanging off the document root. A bulk
+// response carries the same record under bulk[*].query, so that subtree is
+// repeated from N_BULK_BASE with its parents shifted.
+enum WeatherNode : uint8_t {
+  N_ROOT,
+  N_CURRENT,
+  N_UPDATED,
+  N_TEMP_F,
+  N_WIND_MPH,
+  N_WIND_DIR,
+  N_PRESSURE_IN,
+  N_CLOUD,
+  N_FORECAST,
+  N_FORECASTDAY,
+  N_FDAY,
+  N_DAY,
+  N_RAIN_CHANCE,
+  N_HOUR,
+  N_HOUR_ITEM,
+  N_H_EPOCH,
+  N_H_TEMP_F,
+  N_H_WIND_MPH,
+  N_H_PRESSURE_IN,
+  N_H_CLOUD,
+  N_H_RAIN_CHANCE,
+  N_ERROR,
+  N_ERROR_CODE,
+  N_ERROR_MESSAGE,
+  N_RECORD_END,
+  N_BULK = N_RECORD_END,
+  N_BULK_ITEM,
+  N_QUERY,
+  N_CUSTOM_ID,
+  N_BULK_BASE,
+  N_COUNT = N_BULK_BASE + N_RECORD_END - 1
+};
+
+static const JsonPathNode recordPaths[N_RECORD_END] = {
+  { JSON_NO_NODE, "" },
+  { N_ROOT, "current" },
+  { N_CURRENT, "last_updated_epoch" },
+  { N_CURRENT, "temp_f" },
+  { N_CURRENT, "wind_mph" },
+  { N_CURRENT, "wind_dir" },
+  { N_CURRENT, "pressure_in" },
+  { N_CURRENT, "cloud" },
+  { N_ROOT, "forecast" },
+  { N_FORECAST, "forecastday" },
+  { N_FORECASTDAY, "*" },
+  { N_FDAY, "day" },
+  { N_DAY, "daily_chance_of_rain" },
+  { N_FDAY, "hour" },
+  { N_HOUR, "*" },
+  { N_HOUR_ITEM, "time_epoch" },
+  { N_HOUR_ITEM, "temp_f" },
+  { N_HOUR_ITEM, "wind_mph" },
+  { N_HOUR_ITEM, "pressure_in" },
+  { N_HOUR_ITEM, "cloud" },
+  { N_HOUR_ITEM, "chance_of_rain" },
+  { N_ROOT, "error" },
+  { N_ERROR, "code" },
+  { N_ERROR, "message" },
+};
+
+static JsonPathNode bulkPaths[N_COUNT];
+
+static void buildBulkPaths() {
+  if (bulkPaths[0].key) return;
+  memcpy(bulkPaths, recordPaths, sizeof recordPaths);
+  bulkPaths[N_BULK] = { N_ROOT, "bulk" };
+  bulkPaths[N_BULK_ITEM] = { N_BULK, "*" };
+  bulkPaths[N_QUERY] = { N_BULK_ITEM, "query" };
+  bulkPaths[N_CUSTOM_ID] = { N_QUERY, "custom_id" };
+  for (uint8_t i = 1; i < N_RECORD_END; ++i) {
+    uint8_t parent = recordPaths[i].parent;
+    bulkPaths[N_BULK_BASE + i - 1] = {
+      (uint8_t)(parent == N_ROOT ? N_QUERY : N_BULK_BASE + parent - 1), recordPaths[i].key };
+  }
+}
+
+static int16_t quantize(const char *text, double scale) {
+  double v = atof(text) * scale;
+  return (int16_t)constrain(lround(v), -32768L, 32767L);
+}
+
+static int8_t percent(const char *text) {
+  return (int8_t)constrain(atoi(text), -1, 100);
+}
+
+// Where one location's values land. `scanner` supplies the array indices:
+// for daily values index(0) is the day, for hourly ones index(0) is the
+// hour and index(1) the day.
+struct ParseTarget {
+  WeatherSample *sample;
+  HourlyForecast *hourly;
+  const JsonScanner *scanner;
+};
+
+static void setHourly(HourlyForecast &f, uint8_t node, const char *text, int slot) {
+  if (slot < 0 || slot >= FORECAST_HOURS) return;
+  switch (node) {
+    case N_H_EPOCH:
+      if (slot == 0) f.startEpoch = strtoul(text, nullptr, 10);
+      break;
+    case N_H_TEMP_F: f.tempDeciF[slot] = quantize(text, 10); break;
+    case N_H_WIND_MPH: f.windDeciMph[slot] = quantize(text, 10); break;
+    case N_H_PRESSURE_IN: f.pressureCentiIn[slot] = quantize(text, 100); break;
+    case N_H_CLOUD: f.cloud[slot] = percent(text); break;
+    case N_H_RAIN_CHANCE: f.rainChance[slot] = percent(text); break;
+    default: return;
+  }
+  if (slot >= f.hours) f.hours = slot + 1;
+}
+
+static void setField(const ParseTarget &t, uint8_t node, const char *text) {
+  if (node >= N_H_EPOCH && node <= N_H_RAIN_CHANCE) {
+    if (t.hourly) setHourly(*t.hourly, node, text, t.scanner->index(1) * 24 + t.scanner->index(0));
+    return;
+  }
+  WeatherSample &out = *t.sample;
+  switch (node) {
+    case N_UPDATED: out.updatedEpoch = strtoul(text, nullptr, 10); break;
+    case N_TEMP_F: out.tempDeciF = quantize(text, 10); break;
+    case N_WIND_MPH: out.windDeciMph = quantize(text, 10); break;
+    case N_WIND_DIR: out.windDir = windDirFromText(text); break;
+    case N_PRESSURE_IN: out.pressureCentiIn = quantize(text, 100); break;
+    case N_CLOUD: out.cloud = percent(text); break;
+    // The snapshot keeps today's daily values
+    case N_RAIN_CHANCE:
+      if (t.scanner->index() == 0) out.rainChance = percent(text);
+      break;
+    case N_ERROR_CODE: out.apiError = atoi(text); break;
+    case N_ERROR_MESSAGE:
+      // Only the code is kept; the text goes to the log
+      LOG_ERROR("WeatherAPI error: %s", text);
+      if (!out.apiError) out.apiError = SAMPLE_ERROR_UNKNOWN;
+      break;
+  }
+}
+
+static void onWeatherValue(void *ctx, uint8_t node, const char *text, bool) {
+  setField(*(ParseTarget *)ctx, node, text);
+}
+
+bool parseWeather(Stream &in, WeatherSample &out, HourlyForecast *hourly) {
+  sampleClear(out);
+  if (hourly) forecastClear(*hourly);
+  ParseTarget target;
+  JsonScanner scanner(recordPaths, N_RECORD_END, onWeatherValue, &target);
+  target.sample = &out;
+  target.hourly = hourly;
+  target.scanner = &scanner;
+  return scanner.scan(in, WEATHER_TIMEOUT_MS);
+}
+
+struct BulkState {
+  WeatherSample *out;
+  HourlyForecast *hourly;
+  uint8_t count;
+  uint32_t found;
+  int foundCount;
+  // Element being read; copied to out[id] once it closes
+  WeatherSample item;
+  HourlyForecast itemHourly;
+  ParseTarget itemTarget;
+  int id;
+  ParseTarget errorTarget;
+};
+
+static void onBulkValue(void *ctx, uint8_t node, const char *text, bool) {
+  BulkState &bulk = *(BulkState *)ctx;
+  if (node == N_CUSTOM_ID) {
+    bulk.id = atoi(text);
+  } else if (node >= N_BULK_BASE) {
+    setField(bulk.itemTarget, node - N_BULK_BASE + 1, text);
+  } else {
+    setField(bulk.errorTarget, node, text);
+  }
+}
+
+static void onBulkClose(void *ctx, uint8_t node) {
+  BulkState &bulk = *(BulkState *)ctx;
+  if (node != N_BULK_ITEM) return;
+  if (bulk.id >= 0 && bulk.id < bulk.count && !(bulk.found & (1UL << bulk.id))) {
+    bulk.out[bulk.id] = bulk.item;
+    if (bulk.hourly) bulk.hourly[bulk.id] = bulk.itemHourly;
+    bulk.found |= 1UL << bulk.id;
+    bulk.foundCount++;
+  }
+  sampleClear(bulk.item);
+  if (bulk.hourly) forecastClear(bulk.itemHourly);
+  bulk.id = -1;
+}
+
+int parseWeatherBulk(Stream &in, WeatherSample *out, HourlyForecast *hourly, uint8_t count,
+                     uint32_t &found, WeatherSample &error) {
+  buildBulkPaths();
+  BulkState bulk;
+  JsonScanner scanner(bulkPaths, N_COUNT, onBulkValue, &bulk);
+  scanner.setCloseHandler(onBulkClose);
+  bulk.out = out;
+  bulk.hourly = hourly;
+  bulk.count = min(count, (uint8_t)WEATHER_MAX_BULK);
+  bulk.found = 0;
+  bulk.foundCount = 0;
+  sampleClear(bulk.item);
+  if (hourly) forecastClear(bulk.itemHourly);
+  bulk.itemTarget = { &bulk.item, hourly ? &bulk.itemHourly : nullptr, &scanner };
+  bulk.id = -1;
+  sampleClear(error);
+  bulk.errorTarget = { &error, nullptr, &scanner };
+
+  bool ok = scanner.scan(in, WEATHER_TIMEOUT_MS);
+  found = bulk.found;
+  return ok ? bulk.foundCount : -1;
+}
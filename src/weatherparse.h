@@ -0,0 +1,26 @@
+#ifndef WEATHERPARSE_H
+#define WEATHERPARSE_H
+
+#include <Arduino.h>
+#include "weathersample.h"
+#include "forecast.h"
+
+// Largest location list sent in one bulk request
+#define WEATHER_MAX_BULK 16
+
+// Reads one WeatherAPI response body from `in` in a single pass with no heap
+// allocation, quantizing straight into `out`, and the forecast's hours into
+// `hourly` when it is not null. Fields the response omits keep their
+// sentinels. False if the JSON is malformed or the stream stalls.
+bool parseWeather(Stream &in, WeatherSample &out, HourlyForecast *hourly);
+
+// Reads a bulk response ({"bulk":[{"query":{"custom_id":..., ...}}, ...]})
+// where each location was sent with its index as custom_id. Every element
+// is streamed into out[custom_id] (and hourly[custom_id] unless hourly is
+// null) as it completes; `found` gets one bit per
+// index that arrived. A top-level API error is reported in `error`. -1 if
+// the JSON is malformed, otherwise the number of locations found.
+int parseWeatherBulk(Stream &in, WeatherSample *out, HourlyForecast *hourly, uint8_t count,
+                     uint32_t &found, WeatherSample &error);
+
+#endif
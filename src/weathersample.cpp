@@ -0,0 +1,55 @@
+#include <Arduino.h>
+#include "weathersample.h"
+
+static const char *const windNames[] = {
+  "N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+  "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW", "?"
+};
+
+void sampleClear(WeatherSample &s) {
+  s.updatedEpoch = 0;
+  s.tempDeciF = SAMPLE_NO_TEMP;
+  s.pressureCentiIn = SAMPLE_NO_PRESSURE;
+  s.windDeciMph = SAMPLE_NO_WIND;
+  s.cloud = SAMPLE_NO_PERCENT;
+  s.rainChance = SAMPLE_NO_PERCENT;
+  s.sunriseMin = SAMPLE_NO_TIME;
+  s.sunsetMin = SAMPLE_NO_TIME;
+  s.apiError = 0;
+  s.windDir = WIND_UNKNOWN;
+}
+
+WindDir windDirFromText(const char *text) {
+  for (uint8_t i = 0; i < WIND_UNKNOWN; ++i) {
+    if (strcmp(text, windNames[i]) == 0) return (WindDir)i;
+  }
+  return WIND_UNKNOWN;
+}
+
+const char *windDirText(WindDir dir) {
+  return windNames[dir < WIND_UNKNOWN ? dir : WIND_UNKNOWN];
+}
+
+void clockText(uint16_t minutes, char out[9]) {
+  if (minutes >= 24 * 60) {
+    strcpy(out, "N/A");
+    return;
+  }
+  int h = minutes / 60;
+  snprintf(out, 9, "%02d:%02d %s", h % 12 ? h % 12 : 12, minutes % 60, h < 12 ? "AM" : "PM");
+}
+
+const char *weatherErrorText(uint16_t code) {
+  switch (code) {
+    case 1002: return "API key not provided";
+    case 1003: return "Location not provided";
+    case 1005: return "Request URL is invalid";
+    case 1006: return "No matching location found";
+    case 2006: return "API key is invalid";
+    case 2007: return "Monthly quota exceeded";
+    case 2008: return "API key has been disabled";
+    case 2009: return "API key lacks access";
+    case 9999: return "Internal application error";
+    default: return "Unknown error";
+  }
+}
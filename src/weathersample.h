@@ -0,0 +1,61 @@
+#ifndef WEATHERSAMPLE_H
+#define WEATHERSAMPLE_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+// Sentinels for fields the response did not carry. They dequantize to the
+// same defaults the report has always used (-99 F, -1 mph, -1 inHg, -1 %).
+#define SAMPLE_NO_TEMP -990
+#define SAMPLE_NO_WIND -10
+#define SAMPLE_NO_PRESSURE -100
+#define SAMPLE_NO_PERCENT -1
+#define SAMPLE_NO_TIME 0xFFFF
+// apiError for an error object that carried no code
+#define SAMPLE_ERROR_UNKNOWN 1
+
+// The 16 compass points WeatherAPI reports, in clockwise order from north
+enum WindDir : uint8_t {
+  WIND_N, WIND_NNE, WIND_NE, WIND_ENE, WIND_E, WIND_ESE, WIND_SE, WIND_SSE,
+  WIND_S, WIND_SSW, WIND_SW, WIND_WSW, WIND_W, WIND_WNW, WIND_NW, WIND_NNW,
+  WIND_UNKNOWN
+};
+
+// One location's conditions, quantized to the precision WeatherAPI sends
+// (temperature and wind to 0.1, pressure to 0.01), so they round-trip
+// exactly. It is the unit passed between fetch, scoring, the NVS cache
+// and rendering.
+struct __attribute__((packed)) WeatherSample {
+  uint32_t updatedEpoch;   // provider's observation time, 0 if unknown
+  int16_t tempDeciF;       // 0.1 F
+  int16_t pressureCentiIn; // 0.01 inHg
+  int16_t windDeciMph;     // 0.1 mph
+  int8_t cloud;            // percent
+  int8_t rainChance;       // percent, today
+  uint16_t sunriseMin;     // local minutes since midnight, worked out on
+  uint16_t sunsetMin;      // the device (suncalc.h)
+  uint16_t apiError;       // WeatherAPI error.code, 0 if none
+  WindDir windDir;
+};
+
+static_assert(sizeof(WeatherSample) <= 32, "WeatherSample should fit one cache line");
+static_assert(std::is_trivially_copyable<WeatherSample>::value,
+              "WeatherSample is copied and persisted as raw bytes");
+
+void sampleClear(WeatherSample &s);
+
+inline float sampleTempF(const WeatherSample &s) { return (float)(s.tempDeciF / 10.0); }
+inline float samplePressureIn(const WeatherSample &s) { return (float)(s.pressureCentiIn / 100.0); }
+inline double sampleWindMph(const WeatherSample &s) { return s.windDeciMph / 10.0; }
+inline bool sampleHasError(const WeatherSample &s) { return s.apiError != 0; }
+
+WindDir windDirFromText(const char *text);
+const char *windDirText(WindDir dir);
+
+// Minutes since midnight to "07:31 AM", or "N/A"
+void clockText(uint16_t minutes, char out[9]);
+
+// Short description of a WeatherAPI error code
+const char *weatherErrorText(uint16_t code);
+
+#endif
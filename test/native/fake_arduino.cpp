@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <stdarg.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "fakes.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now() - bootTime).count();
+}
+
+uint64_t fakeNanos() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+String::String(double v, unsigned int decimals) {
+  char buf[48];
+  snprintf(buf, sizeof buf, "%.*f", (int)decimals, v);
+  s = buf;
+}
+
+void String::trim() {
+  size_t start = 0;
+  while (start < s.size() && isspace((unsigned char)s[start])) ++start;
+  size_t end = s.size();
+  while (end > start && isspace((unsigned char)s[end - 1])) --end;
+  s = s.substr(start, end - start);
+}
+
+size_t Print::write(const uint8_t *buf, size_t n) {
+  size_t done = 0;
+  while (done < n && write(buf[done])) ++done;
+  return done;
+}
+
+size_t Print::printf(const char *fmt, ...) {
+  char small[128];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(small, sizeof small, fmt, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof small) return write((const uint8_t *)small, len);
+  std::string big(len + 1, '\0');
+  va_start(args, fmt);
+  vsnprintf(&big[0], big.size(), fmt, args);
+  va_end(args);
+  return write((const uint8_t *)big.data(), len);
+}
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) return c;
+    yield();
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(uint8_t *buf, size_t n) {
+  size_t count = 0;
+  while (count < n) {
+    int c = timedRead();
+    if (c < 0) break;
+    buf[count++] = (uint8_t)c;
+  }
+  return count;
+}
+
+static std::mutex serialLock;
+static std::string serialOut;
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t n) {
+  static const bool echo = getenv("FAKE_LOG_ECHO") != nullptr;
+  if (echo) fwrite(buf, 1, n, stdout);
+  std::lock_guard<std::mutex> held(serialLock);
+  serialOut.append((const char *)buf, n);
+  return n;
+}
+
+std::string fakeSerialOutput() {
+  std::lock_guard<std::mutex> held(serialLock);
+  return serialOut;
+}
+
+void fakeSerialClear() {
+  std::lock_guard<std::mutex> held(serialLock);
+  serialOut.clear();
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return 200000;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  return 150000;
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return 110000;
+}
+
+void EspClass::restart() {
+  abort();
+}
+
+bool psramFound() {
+  return false;
+}
+
+void configTime(long, int, const char *, const char *, const char *) {}
+
+void configTzTime(const char *tz, const char *, const char *, const char *) {
+  setenv("TZ", tz, 1);
+  tzset();
+}
+
+std::string fixtureRead(const char *name) {
+  std::string path = std::string(TEST_FIXTURE_DIR) + "/" + name;
+  std::string bytes;
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return bytes;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof buf, f)) > 0) bytes.append(buf, n);
+  fclose(f);
+  return bytes;
+}
@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <SD.h>
+#include <map>
+#include <mutex>
+#include "fakes.h"
+
+SPIClass SPI;
+SDFS SD;
+
+static std::mutex filesLock;
+static std::map<std::string, std::shared_ptr<fs::FileData>> files;
+
+void fakeSdPut(const char *path, const std::string &bytes, time_t mtime) {
+  std::shared_ptr<fs::FileData> data(new fs::FileData);
+  data->path = path;
+  data->bytes.assign(bytes.begin(), bytes.end());
+  data->mtime = mtime;
+  std::lock_guard<std::mutex> held(filesLock);
+  files[path] = data;
+}
+
+void fakeSdClear() {
+  std::lock_guard<std::mutex> held(filesLock);
+  files.clear();
+}
+
+namespace fs {
+
+bool File::seek(uint32_t offset, SeekMode mode) {
+  if (!data) return false;
+  size_t base = mode == SeekSet ? 0 : mode == SeekCur ? pos : data->bytes.size();
+  if (base + offset > data->bytes.size()) return false;
+  pos = base + offset;
+  return true;
+}
+
+const char *File::name() const {
+  if (!data) return "";
+  size_t slash = data->path.rfind('/');
+  return data->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+int File::read() {
+  if (!data || pos >= data->bytes.size()) return -1;
+  return data->bytes[pos++];
+}
+
+int File::peek() {
+  if (!data || pos >= data->bytes.size()) return -1;
+  return data->bytes[pos];
+}
+
+size_t File::read(uint8_t *buf, size_t n) {
+  if (!data) return 0;
+  n = min(n, data->bytes.size() - pos);
+  memcpy(buf, data->bytes.data() + pos, n);
+  pos += n;
+  return n;
+}
+
+size_t File::write(const uint8_t *buf, size_t n) {
+  if (!data || !writable) return 0;
+  if (pos + n > data->bytes.size()) data->bytes.resize(pos + n);
+  memcpy(data->bytes.data() + pos, buf, n);
+  pos += n;
+  data->mtime = time(nullptr);
+  return n;
+}
+
+File FS::open(const char *path, const char *mode) {
+  std::lock_guard<std::mutex> held(filesLock);
+  auto it = files.find(path);
+  if (mode[0] == 'r') return it == files.end() ? File() : File(it->second, false);
+
+  std::shared_ptr<FileData> data;
+  if (mode[0] == 'a' && it != files.end()) {
+    data = it->second;
+  } else {
+    data.reset(new FileData);
+    data->path = path;
+    data->mtime = time(nullptr);
+    files[path] = data;
+  }
+  return File(data, true);
+}
+
+bool FS::exists(const char *path) {
+  std::lock_guard<std::mutex> held(filesLock);
+  return files.count(path) != 0;
+}
+
+bool FS::remove(const char *path) {
+  std::lock_guard<std::mutex> held(filesLock);
+  return files.erase(path) != 0;
+}
+
+bool FS::rename(const char *from, const char *to) {
+  std::lock_guard<std::mutex> held(filesLock);
+  auto it = files.find(from);
+  if (it == files.end()) return false;
+  std::shared_ptr<FileData> data = it->second;
+  files.erase(it);
+  data->path = to;
+  files[to] = data;
+  return true;
+}
+
+} // namespace fs
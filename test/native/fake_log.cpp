@@ -0,0 +1,35 @@
+#include <Arduino.h>
+#include "log.h"
+#include "fakes.h"
+
+// Splits what the real drain task wrote to the fake Serial into lines
+
+static std::string lineAt(const std::string &out, uint32_t index, uint32_t &count) {
+  std::string found;
+  count = 0;
+  size_t start = 0;
+  for (size_t end; (end = out.find('\n', start)) != std::string::npos; start = end + 1) {
+    if (count++ == index) found = out.substr(start, end - start);
+  }
+  return found;
+}
+
+uint32_t fakeLogLines() {
+  logFlush();
+  uint32_t count;
+  lineAt(fakeSerialOutput(), UINT32_MAX, count);
+  return count;
+}
+
+std::string fakeLogLine(uint32_t i) {
+  logFlush();
+  uint32_t count;
+  std::string line = lineAt(fakeSerialOutput(), i, count);
+  // "[I] "
+  return line.size() >= 4 ? line.substr(4) : line;
+}
+
+void fakeLogReset() {
+  logFlush();
+  fakeSerialClear();
+}
@@ -0,0 +1,44 @@
+#include <map>
+#include <mutex>
+#include <zlib.h>
+#include "esp32/rom/miniz.h"
+
+// One zlib stream per decompressor address, reset when tinfl_init() has
+// zeroed m_state. Streams are kept for reuse rather than freed.
+static std::mutex streamsLock;
+static std::map<const tinfl_decompressor *, z_stream *> streams;
+
+static z_stream *streamFor(tinfl_decompressor *r) {
+  std::lock_guard<std::mutex> held(streamsLock);
+  z_stream *&z = streams[r];
+  if (!z) {
+    z = new z_stream();
+    if (inflateInit2(z, -MAX_WBITS) != Z_OK) return nullptr;
+  } else if (r->m_state == 0) {
+    inflateReset(z);
+  }
+  r->m_state = 1;
+  return z;
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *pIn_buf_next,
+                              size_t *pIn_buf_size, mz_uint8 *pOut_buf_start,
+                              mz_uint8 *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags) {
+  (void)pOut_buf_start;
+  if (decomp_flags & (TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF)) {
+    return TINFL_STATUS_BAD_PARAM;
+  }
+  z_stream *z = streamFor(r);
+  if (!z) return TINFL_STATUS_FAILED;
+  z->next_in = (Bytef *)pIn_buf_next;
+  z->avail_in = *pIn_buf_size;
+  z->next_out = pOut_buf_next;
+  z->avail_out = *pOut_buf_size;
+  int rc = inflate(z, Z_NO_FLUSH);
+  *pIn_buf_size -= z->avail_in;
+  *pOut_buf_size -= z->avail_out;
+  if (rc == Z_STREAM_END) return TINFL_STATUS_DONE;
+  if (rc != Z_OK && rc != Z_BUF_ERROR) return TINFL_STATUS_FAILED;
+  return z->avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
@@ -0,0 +1,69 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include <map>
+#include <mutex>
+#include <vector>
+
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+
+static std::mutex nvsLock;
+static std::map<std::string, Namespace> nvs;
+
+void fakePreferencesClear() {
+  std::lock_guard<std::mutex> held(nvsLock);
+  nvs.clear();
+}
+
+bool Preferences::begin(const char *name, bool ro) {
+  // NVS namespaces are at most 15 characters
+  if (!name || strlen(name) > 15) return false;
+  space = name;
+  readOnly = ro;
+  opened = true;
+  return true;
+}
+
+bool Preferences::clear() {
+  if (!opened || readOnly) return false;
+  std::lock_guard<std::mutex> held(nvsLock);
+  nvs[space].clear();
+  return true;
+}
+
+bool Preferences::remove(const char *key) {
+  if (!opened || readOnly) return false;
+  std::lock_guard<std::mutex> held(nvsLock);
+  return nvs[space].erase(key) != 0;
+}
+
+bool Preferences::isKey(const char *key) {
+  std::lock_guard<std::mutex> held(nvsLock);
+  return opened && nvs[space].count(key) != 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) {
+  if (!opened || readOnly || strlen(key) > 15) return 0;
+  std::lock_guard<std::mutex> held(nvsLock);
+  const uint8_t *bytes = (const uint8_t *)value;
+  nvs[space][key].assign(bytes, bytes + len);
+  return len;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen) {
+  std::lock_guard<std::mutex> held(nvsLock);
+  if (!opened) return 0;
+  Namespace &ns = nvs[space];
+  auto it = ns.find(key);
+  // Like NVS, a value larger than the buffer is not read at all
+  if (it == ns.end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char *key) {
+  std::lock_guard<std::mutex> held(nvsLock);
+  if (!opened) return 0;
+  Namespace &ns = nvs[space];
+  auto it = ns.find(key);
+  return it == ns.end() ? 0 : it->second.size();
+}
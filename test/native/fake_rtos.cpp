@@ -0,0 +1,135 @@
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "freertos/semphr.h"
+
+// Handles are never freed: tasks run for the life of the process, and a
+// detached thread may still be waiting on one at exit.
+struct FakeTask {
+  std::mutex lock;
+  std::condition_variable wake;
+  uint32_t notified = 0;
+};
+
+struct FakeSemaphore {
+  std::mutex lock;
+  std::condition_variable wake;
+  UBaseType_t count;
+  UBaseType_t max;
+};
+
+static thread_local FakeTask *currentTask = nullptr;
+
+// Waits on `wake` until `ready()` or the timeout; true if ready
+template <typename Ready>
+static bool waitFor(std::condition_variable &wake, std::unique_lock<std::mutex> &held,
+                    TickType_t ticks, Ready ready) {
+  if (ticks == portMAX_DELAY) {
+    wake.wait(held, ready);
+    return true;
+  }
+  return wake.wait_for(held, std::chrono::milliseconds(ticks), ready);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *, uint32_t, void *arg,
+                                   UBaseType_t, TaskHandle_t *created, BaseType_t) {
+  FakeTask *task = new FakeTask;
+  if (created) *created = task;
+  std::thread([fn, arg, task] {
+    currentTask = task;
+    fn(arg);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, arg, priority, created, tskNO_AFFINITY);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (!currentTask) currentTask = new FakeTask;
+  return currentTask;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  FakeTask &task = *(FakeTask *)xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> held(task.lock);
+  if (!waitFor(task.wake, held, ticksToWait, [&] { return task.notified > 0; })) return 0;
+  uint32_t value = task.notified;
+  task.notified = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+  FakeTask &task = *(FakeTask *)handle;
+  std::lock_guard<std::mutex> held(task.lock);
+  task.notified++;
+  task.wake.notify_all();
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)millis();
+}
+
+BaseType_t xPortGetCoreID() {
+  return 1;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+  FakeSemaphore *sem = new FakeSemaphore;
+  sem->count = initialCount;
+  sem->max = maxCount;
+  return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t ticksToWait) {
+  FakeSemaphore &sem = *(FakeSemaphore *)handle;
+  std::unique_lock<std::mutex> held(sem.lock);
+  if (!waitFor(sem.wake, held, ticksToWait, [&] { return sem.count > 0; })) return pdFALSE;
+  sem.count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t handle) {
+  FakeSemaphore &sem = *(FakeSemaphore *)handle;
+  std::lock_guard<std::mutex> held(sem.lock);
+  if (sem.count >= sem.max) return pdFALSE;
+  sem.count++;
+  sem.wake.notify_one();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t) {}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+  if (caps & MALLOC_CAP_SPIRAM) return nullptr;
+  return malloc(size);
+}
+
+void heap_caps_free(void *ptr) {
+  free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  return caps & MALLOC_CAP_SPIRAM ? 0 : 200000;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return caps & MALLOC_CAP_SPIRAM ? 0 : 110000;
+}
@@ -0,0 +1,246 @@
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <zlib.h>
+
+// Defined in main.cpp on the device
+TFT_eSPI tft;
+
+// What TFT_eSPI's ST7796 driver programs for each rotation. A MADCTL
+// written later is compared against this: with MV clear MX mirrors x and
+// MY mirrors y; with MV set the controller's axes are exchanged, so MX
+// mirrors y and MY mirrors x.
+static uint8_t baseMadctl(uint8_t rotation) {
+  switch (rotation) {
+    case 0: return TFT_MAD_MX | TFT_MAD_COLOR_ORDER;
+    case 1: return TFT_MAD_MV | TFT_MAD_COLOR_ORDER;
+    case 2: return TFT_MAD_MY | TFT_MAD_COLOR_ORDER;
+    default: return TFT_MAD_MX | TFT_MAD_MY | TFT_MAD_MV | TFT_MAD_COLOR_ORDER;
+  }
+}
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : frame((size_t)w * h, TFT_BLACK), rotation(0), madctl(baseMadctl(0)), _width(w),
+      _height(h), swapBytes(false), dmaOn(false), depth(0), lastCommand(0), winX(0), winY(0),
+      winW(0), winH(0), winPos(0), pending(), bus(), cursorX(0), cursorY(0), textSize(1),
+      textFg(TFT_WHITE), textBg(TFT_BLACK), textBgSet(false) {}
+
+void TFT_eSPI::init() {
+  setRotation(0);
+  fakeReset();
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+  rotation = r % 4;
+  _width = rotation & 1 ? TFT_HEIGHT : TFT_WIDTH;
+  _height = rotation & 1 ? TFT_WIDTH : TFT_HEIGHT;
+  // One transaction for the MADCTL command and its parameter
+  bool wasOpen = depth;
+  if (!wasOpen) startWrite();
+  writecommand(TFT_MADCTL);
+  writedata(baseMadctl(rotation));
+  if (!wasOpen) endWrite();
+}
+
+void TFT_eSPI::fakeReset() {
+  dmaWait();
+  bus = FakeBusStats();
+  text.clear();
+}
+
+// Any bus access outside startWrite()/endWrite() is its own transaction
+void TFT_eSPI::busTouch() {
+  if (!depth) bus.transactions++;
+}
+
+void TFT_eSPI::startWrite() {
+  // TFT_eSPI does not nest these: the first endWrite() releases the bus
+  if (!depth) bus.transactions++;
+  depth = 1;
+}
+
+void TFT_eSPI::endWrite() {
+  dmaWait();
+  depth = 0;
+}
+
+void TFT_eSPI::writecommand(uint8_t c) {
+  busTouch();
+  dmaWait();
+  bus.commands++;
+  lastCommand = c;
+}
+
+void TFT_eSPI::writedata(uint8_t d) {
+  busTouch();
+  if (lastCommand == TFT_MADCTL) madctl = d;
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+  busTouch();
+  dmaWait();
+  bus.windows++;
+  winX = x;
+  winY = y;
+  winW = w;
+  winH = h;
+  winPos = 0;
+}
+
+void TFT_eSPI::pushPixels(const void *data, uint32_t len) {
+  busTouch();
+  dmaWait();
+  applyPixels((const uint16_t *)data, len, swapBytes);
+  bus.pixelBytes += len * 2;
+}
+
+bool TFT_eSPI::initDMA(bool) {
+  dmaOn = true;
+  return true;
+}
+
+void TFT_eSPI::pushPixelsDMA(uint16_t *image, uint32_t len) {
+  if (!len || !dmaOn) return;
+  busTouch();
+  dmaWait();
+  // The driver swaps the caller's buffer in place before sending it
+  if (swapBytes) {
+    for (uint32_t i = 0; i < len; ++i) image[i] = (image[i] >> 8) | (image[i] << 8);
+  }
+  pending.pixels = image;
+  pending.len = len;
+  bus.pixelBytes += len * 2;
+  bus.dmaTransfers++;
+}
+
+void TFT_eSPI::dmaWait() {
+  if (!pending.len) return;
+  PendingDma done = pending;
+  pending = PendingDma();
+  applyPixels(done.pixels, done.len, false);
+}
+
+// Bytes go out in memory order unless swapped, and the panel reads them
+// high byte first
+void TFT_eSPI::applyPixels(const uint16_t *pixels, uint32_t len, bool swap) {
+  if (winW <= 0 || winH <= 0) return;
+  for (uint32_t i = 0; i < len; ++i) {
+    uint16_t color = swap ? pixels[i] : (uint16_t)((pixels[i] >> 8) | (pixels[i] << 8));
+    plot(winX + winPos % winW, winY + winPos / winW, color);
+    // The controller wraps to the window's start once it is full
+    winPos = (winPos + 1) % (winW * winH);
+  }
+}
+
+void TFT_eSPI::plot(int32_t ax, int32_t ay, uint16_t color) {
+  uint8_t base = baseMadctl(rotation);
+  uint8_t diff = madctl ^ base;
+  bool exchanged = base & TFT_MAD_MV;
+  int32_t x = ax;
+  int32_t y = ay;
+  if (diff & (exchanged ? TFT_MAD_MY : TFT_MAD_MX)) x = _width - 1 - x;
+  if (diff & (exchanged ? TFT_MAD_MX : TFT_MAD_MY)) y = _height - 1 - y;
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  frame[physIndex(x, y)] = color;
+}
+
+size_t TFT_eSPI::physIndex(int32_t x, int32_t y) const {
+  int32_t px, py;
+  switch (rotation) {
+    case 0: px = x; py = y; break;
+    case 1: px = TFT_WIDTH - 1 - y; py = x; break;
+    case 2: px = TFT_WIDTH - 1 - x; py = TFT_HEIGHT - 1 - y; break;
+    default: px = y; py = TFT_HEIGHT - 1 - x; break;
+  }
+  return (size_t)py * TFT_WIDTH + px;
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  busTouch();
+  dmaWait();
+  bus.windows++;
+  bus.pixelBytes += (uint32_t)max(w, 0) * max(h, 0) * 2;
+  paint(x, y, w, h, color);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  fillRect(x, y, w, 1, color);
+  fillRect(x, y + h - 1, w, 1, color);
+  fillRect(x, y + 1, 1, h - 2, color);
+  fillRect(x + w - 1, y + 1, 1, h - 2, color);
+}
+
+void TFT_eSPI::paint(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color) {
+  for (int32_t r = max(y, (int32_t)0); r < min(y + h, (int32_t)_height); ++r) {
+    for (int32_t c = max(x, (int32_t)0); c < min(x + w, (int32_t)_width); ++c) {
+      frame[physIndex(c, r)] = color;
+    }
+  }
+}
+
+size_t TFT_eSPI::write(uint8_t c) {
+  text += (char)c;
+  if (c == '\n') {
+    cursorX = 0;
+    cursorY += fontHeight();
+    return 1;
+  }
+  if (c == '\r') return 1;
+  int16_t cellW = 6 * textSize;
+  if (cursorX + cellW > _width) {
+    cursorX = 0;
+    cursorY += fontHeight();
+  }
+  if (textBgSet) paint(cursorX, cursorY, cellW, fontHeight(), textBg);
+  if (c != ' ') paint(cursorX, cursorY, 5 * textSize, 7 * textSize, textFg);
+  cursorX += cellW;
+  return 1;
+}
+
+uint16_t TFT_eSPI::fakePixel(int32_t x, int32_t y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+  return frame[physIndex(x, y)];
+}
+
+static void pngChunk(FILE *f, const char *type, const uint8_t *data, uint32_t len) {
+  uint8_t head[8] = { (uint8_t)(len >> 24), (uint8_t)(len >> 16), (uint8_t)(len >> 8),
+                      (uint8_t)len };
+  memcpy(head + 4, type, 4);
+  uLong crc = crc32(crc32(0, nullptr, 0), head + 4, 4);
+  if (len) crc = crc32(crc, data, len);
+  uint8_t tail[4] = { (uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8),
+                      (uint8_t)crc };
+  fwrite(head, 1, 8, f);
+  if (len) fwrite(data, 1, len, f);
+  fwrite(tail, 1, 4, f);
+}
+
+bool TFT_eSPI::fakeWritePng(const char *path) const {
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)_height * (1 + _width * 3));
+  for (int32_t y = 0; y < _height; ++y) {
+    raw.push_back(0); // filter: none
+    for (int32_t x = 0; x < _width; ++x) {
+      uint16_t c = fakePixel(x, y);
+      uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+      raw.push_back((r << 3) | (r >> 2));
+      raw.push_back((g << 2) | (g >> 4));
+      raw.push_back((b << 3) | (b >> 2));
+    }
+  }
+  uLongf packedLen = compressBound(raw.size());
+  std::vector<uint8_t> packed(packedLen);
+  if (compress(packed.data(), &packedLen, raw.data(), raw.size()) != Z_OK) return false;
+
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  fwrite(signature, 1, sizeof signature, f);
+  uint8_t ihdr[13] = { (uint8_t)(_width >> 24), (uint8_t)(_width >> 16), (uint8_t)(_width >> 8),
+                       (uint8_t)_width, (uint8_t)(_height >> 24), (uint8_t)(_height >> 16),
+                       (uint8_t)(_height >> 8), (uint8_t)_height,
+                       8, 2, 0, 0, 0 }; // 8-bit RGB, deflate, no filter, no interlace
+  pngChunk(f, "IHDR", ihdr, sizeof ihdr);
+  pngChunk(f, "IDAT", packed.data(), packedLen);
+  pngChunk(f, "IEND", nullptr, 0);
+  return fclose(f) == 0;
+}
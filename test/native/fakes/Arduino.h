@@ -0,0 +1,177 @@
+#ifndef FAKE_ARDUINO_H
+#define FAKE_ARDUINO_H
+
+// Host stand-in for the parts of the ESP32 Arduino core the sources use.
+// Only built by the native env; see test/README.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+
+using std::min;
+using std::max;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define F(s) (s)
+// The core the fakes model; set to 2 for the HTTPClient without
+// setAcceptEncoding()
+#ifndef ESP_ARDUINO_VERSION_MAJOR
+#define ESP_ARDUINO_VERSION_MAJOR 3
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+class String {
+ public:
+  String(const char *s = "") : s(s ? s : "") {}
+  String(const char *s, size_t n) : s(s, strnlen(s, n)) {}
+  String(const std::string &s) : s(s) {}
+  explicit String(char c) : s(1, c) {}
+  explicit String(int v) : s(std::to_string(v)) {}
+  explicit String(unsigned int v) : s(std::to_string(v)) {}
+  explicit String(long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long v) : s(std::to_string(v)) {}
+  explicit String(double v, unsigned int decimals = 2);
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  void reserve(unsigned int n) { s.reserve(n); }
+  char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  String &operator+=(const String &o) { s += o.s; return *this; }
+  String &operator+=(const char *o) { s += o; return *this; }
+  String &operator+=(char c) { s += c; return *this; }
+  bool concat(const String &o) { s += o.s; return true; }
+  friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+  friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.s); }
+
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const String &o) const { return s != o.s; }
+  bool operator!=(const char *o) const { return s != o; }
+  bool operator<(const String &o) const { return s < o.s; }
+  bool equals(const String &o) const { return s == o.s; }
+  bool equalsIgnoreCase(const String &o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+  bool startsWith(const String &o) const { return s.compare(0, o.s.size(), o.s) == 0; }
+  bool endsWith(const String &o) const {
+    return s.size() >= o.s.size() && s.compare(s.size() - o.s.size(), o.s.size(), o.s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return pos(s.find(c, from)); }
+  int indexOf(const String &o, unsigned int from = 0) const { return pos(s.find(o.s, from)); }
+  int lastIndexOf(char c) const { return pos(s.rfind(c)); }
+  String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    return from < to && from < s.size() ? String(s.substr(from, to - from)) : String();
+  }
+  long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s.c_str(), nullptr); }
+  void trim();
+  void toLowerCase() { for (char &c : s) c = tolower((unsigned char)c); }
+  void toUpperCase() { for (char &c : s) c = toupper((unsigned char)c); }
+
+ private:
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  std::string s;
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n);
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int decimals = 2) { return printf("%.*f", decimals, v); }
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+  size_t println() { return write("\r\n"); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+ public:
+  Stream() : _timeout(1000) {}
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+
+  void setTimeout(unsigned long ms) { _timeout = ms; }
+  // Waits up to the timeout for each byte, as the core's Stream does
+  virtual size_t readBytes(uint8_t *buf, size_t n);
+  size_t readBytes(char *buf, size_t n) { return readBytes((uint8_t *)buf, n); }
+
+ protected:
+  int timedRead();
+  unsigned long _timeout;
+};
+
+// Keeps what is written for fakeSerialOutput(); FAKE_LOG_ECHO=1 in the
+// environment also prints it
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long) {}
+  void end() {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getFreePsram() { return 0; }
+  void restart();
+};
+
+extern EspClass ESP;
+
+bool psramFound();
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char *server1,
+                const char *server2 = nullptr, const char *server3 = nullptr);
+// Sets TZ only; the host clock is already right
+void configTzTime(const char *tz, const char *server1, const char *server2 = nullptr,
+                  const char *server3 = nullptr);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef FAKE_FS_H
+#define FAKE_FS_H
+
+// In-memory file system behind SD. Files are shared byte vectors, so a
+// File stays readable after the path is overwritten, as on FAT.
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FileData {
+  std::string path;
+  std::vector<uint8_t> bytes;
+  time_t mtime;
+};
+
+class File : public Stream {
+ public:
+  File() : pos(0), writable(false) {}
+  File(std::shared_ptr<FileData> data, bool writable)
+      : data(data), pos(writable ? data->bytes.size() : 0), writable(writable) {}
+
+  operator bool() const { return (bool)data; }
+  size_t size() const { return data ? data->bytes.size() : 0; }
+  size_t position() const { return pos; }
+  bool seek(uint32_t offset, SeekMode mode = SeekSet);
+  time_t getLastWrite() const { return data ? data->mtime : 0; }
+  const char *path() const { return data ? data->path.c_str() : ""; }
+  const char *name() const;
+  void close() { data.reset(); }
+
+  int available() override { return data ? (int)(data->bytes.size() - pos) : 0; }
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t *buf, size_t n);
+  size_t readBytes(uint8_t *buf, size_t n) override { return read(buf, n); }
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+
+ private:
+  std::shared_ptr<FileData> data;
+  size_t pos;
+  bool writable;
+};
+
+class FS {
+ public:
+  File open(const char *path, const char *mode = FILE_READ);
+  File open(const String &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+  bool exists(const char *path);
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path);
+  bool rename(const char *from, const char *to);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif
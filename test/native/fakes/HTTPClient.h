@@ -0,0 +1,86 @@
+#ifndef FAKE_HTTPCLIENT_H
+#define FAKE_HTTPCLIENT_H
+
+// HTTPClient answering from routes registered by the test instead of the
+// network. Requests are recorded with the headers the ESP32 core would
+// send, its own Accept-Encoding included: replaceable with
+// setAcceptEncoding() from core 3.0 on, always the default before.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <vector>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+struct FakeHttpRequest {
+  std::string method;
+  std::string uri;
+  std::string headers; // "Name: value\r\n" lines
+  std::string body;
+};
+
+// A canned response for every request whose URI contains `match`,
+// replacing any earlier one for the same `match`. `body` is sent as given:
+// pass it through fakeHttpChunked() first for a chunked response.
+void fakeHttpRoute(const std::string &match, int status, const std::string &headers,
+                   const std::string &body);
+void fakeHttpReset();
+std::vector<FakeHttpRequest> fakeHttpRequests();
+std::string fakeHttpChunked(const std::string &body, size_t chunkBytes);
+
+class HTTPClient {
+ public:
+  HTTPClient()
+      : client(nullptr), acceptEncoding("identity;q=1,chunked;q=0.1,*;q=0"), reuse(true),
+        http10(false), size(-1) {}
+
+  bool begin(WiFiClient &client, const char *host, uint16_t port, const char *uri);
+  bool begin(WiFiClient &client, const String &url);
+  void end();
+  void setReuse(bool on) { reuse = on; }
+  void useHTTP10(bool on) { http10 = on; }
+  void setTimeout(uint16_t) {}
+  void setConnectTimeout(int32_t) {}
+  void addHeader(const String &name, const String &value);
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  void setAcceptEncoding(const String &value) { acceptEncoding = value.c_str(); }
+#endif
+  void collectHeaders(const char *names[], size_t count);
+
+  int GET();
+  int POST(const String &payload);
+  int POST(uint8_t *payload, size_t size);
+
+  String header(const char *name);
+  int getSize() const { return size; }
+  WiFiClient &getStream() { return *client; }
+  WiFiClient *getStreamPtr() { return client; }
+  bool connected() { return client && client->connected(); }
+
+ private:
+  int send(const char *method, const std::string &payload);
+
+  WiFiClient *client;
+  std::string host;
+  uint16_t port;
+  std::string uri;
+  std::string requestHeaders;
+  std::string acceptEncoding;
+  std::vector<std::string> wanted;
+  std::vector<std::pair<std::string, std::string>> responseHeaders;
+  bool reuse;
+  bool http10;
+  int size;
+};
+
+#endif
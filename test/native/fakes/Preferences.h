@@ -0,0 +1,29 @@
+#ifndef FAKE_PREFERENCES_H
+#define FAKE_PREFERENCES_H
+
+// NVS in a process-wide map of namespaces; contents last until
+// fakePreferencesClear()
+
+#include <Arduino.h>
+
+void fakePreferencesClear();
+
+class Preferences {
+ public:
+  Preferences() : readOnly(true), opened(false) {}
+  bool begin(const char *name, bool readOnly = false);
+  void end() { opened = false; }
+  bool clear();
+  bool remove(const char *key);
+  bool isKey(const char *key);
+  size_t putBytes(const char *key, const void *value, size_t len);
+  size_t getBytes(const char *key, void *buf, size_t maxLen);
+  size_t getBytesLength(const char *key);
+
+ private:
+  std::string space;
+  bool readOnly;
+  bool opened;
+};
+
+#endif
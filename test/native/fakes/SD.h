@@ -0,0 +1,18 @@
+#ifndef FAKE_SD_H
+#define FAKE_SD_H
+
+#include <FS.h>
+#include <SPI.h>
+
+class SDFS : public fs::FS {
+ public:
+  bool begin(uint8_t ssPin = 5, SPIClass &spi = SPI, uint32_t frequency = 4000000,
+             const char *mountpoint = "/sd", uint8_t maxFiles = 5, bool formatIfEmpty = false) {
+    return true;
+  }
+  void end() {}
+};
+
+extern SDFS SD;
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef FAKE_SPI_H
+#define FAKE_SPI_H
+
+#include <Arduino.h>
+
+#define HSPI 2
+#define VSPI 3
+
+class SPIClass {
+ public:
+  explicit SPIClass(uint8_t bus = HSPI) { (void)bus; }
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+  void end() {}
+};
+
+extern SPIClass SPI;
+
+#endif
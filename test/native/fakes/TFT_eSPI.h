@@ -0,0 +1,145 @@
+#ifndef FAKE_TFT_ESPI_H
+#define FAKE_TFT_ESPI_H
+
+// TFT_eSPI driving a 320x480 ST7796 on the host: pixels land in an
+// in-memory framebuffer, and the bus traffic the real driver would
+// generate is counted so the draw code's own SPI accounting can be checked
+// against it. DMA pushes are only applied at the next dmaWait() (or the
+// next push), so a buffer reused too early shows up in the picture.
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <vector>
+
+// -DFAKE_TFT_OTHER_DRIVER builds the draw code as for a non-ST7796 panel
+#ifndef FAKE_TFT_OTHER_DRIVER
+#define ST7796_DRIVER
+#endif
+#define TFT_WIDTH 320
+#define TFT_HEIGHT 480
+#ifndef SPI_FREQUENCY
+#define SPI_FREQUENCY 40000000
+#endif
+
+#define TFT_MADCTL 0x36
+#define TFT_MAD_MY 0x80
+#define TFT_MAD_MX 0x40
+#define TFT_MAD_MV 0x20
+#define TFT_MAD_ML 0x10
+#define TFT_MAD_RGB 0x00
+#define TFT_MAD_BGR 0x08
+#define TFT_MAD_COLOR_ORDER TFT_MAD_BGR
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGREEN 0x03E0
+#define TFT_DARKGREY 0x7BEF
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_ORANGE 0xFDA0
+
+// What the driver put on the wire since the last fakeReset()
+struct FakeBusStats {
+  uint32_t pixelBytes;   // pixel data after RAMWR
+  uint32_t windows;      // CASET/PASET/RAMWR sequences
+  uint32_t transactions; // chip select assertions
+  uint32_t commands;     // other commands, e.g. MADCTL
+  uint32_t dmaTransfers;
+};
+
+class TFT_eSPI : public Print {
+ public:
+  TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+
+  void init();
+  void begin() { init(); }
+  void setRotation(uint8_t r);
+  uint8_t getRotation() const { return rotation; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+  void startWrite();
+  void endWrite();
+  void writecommand(uint8_t c);
+  void writedata(uint8_t d);
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+  void pushPixels(const void *data, uint32_t len);
+  void setSwapBytes(bool swap) { swapBytes = swap; }
+  bool getSwapBytes() const { return swapBytes; }
+
+  bool initDMA(bool ctrlCS = false);
+  void deInitDMA() { dmaWait(); dmaOn = false; }
+  void pushPixelsDMA(uint16_t *image, uint32_t len);
+  bool dmaBusy() const { return pending.len != 0; }
+  void dmaWait();
+
+  void fillScreen(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawPixel(int32_t x, int32_t y, uint32_t color) { fillRect(x, y, 1, 1, color); }
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) const {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  // Text in the built-in 6x8 font, scaled by the text size and wrapped at
+  // the right edge. Each character is drawn as a solid 5x7 block in the
+  // foreground color over its cell in the background color, if one is
+  // set. Text is not counted as bus traffic.
+  void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+  int16_t getCursorX() const { return cursorX; }
+  int16_t getCursorY() const { return cursorY; }
+  void setTextColor(uint16_t fg) { textFg = fg; textBgSet = false; }
+  void setTextColor(uint16_t fg, uint16_t bg) { textFg = fg; textBg = bg; textBgSet = true; }
+  void setTextSize(uint8_t size) { textSize = size ? size : 1; }
+  int16_t fontHeight() const { return 8 * textSize; }
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Test side
+  void fakeReset();
+  FakeBusStats fakeStats() const { return bus; }
+  // RGB565 at (x, y) in the current rotation
+  uint16_t fakePixel(int32_t x, int32_t y) const;
+  // Writes the current rotation's view as an 8-bit RGB PNG
+  bool fakeWritePng(const char *path) const;
+  // Characters written since the last fakeReset()
+  const std::string &fakeText() const { return text; }
+
+ private:
+  struct PendingDma {
+    const uint16_t *pixels;
+    uint32_t len;
+  };
+
+  void busTouch();
+  void applyPixels(const uint16_t *pixels, uint32_t len, bool swap);
+  void plot(int32_t ax, int32_t ay, uint16_t color);
+  void paint(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color);
+  size_t physIndex(int32_t x, int32_t y) const;
+
+  std::vector<uint16_t> frame; // rotation 0, row-major
+  uint8_t rotation;
+  uint8_t madctl;
+  int16_t _width;
+  int16_t _height;
+  bool swapBytes;
+  bool dmaOn;
+  int depth;
+  uint8_t lastCommand;
+  // Address window in controller coordinates and the write pointer in it
+  int32_t winX, winY, winW, winH, winPos;
+  PendingDma pending;
+  FakeBusStats bus;
+  int16_t cursorX, cursorY;
+  uint8_t textSize;
+  uint16_t textFg, textBg;
+  bool textBgSet;
+  std::string text;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef FAKE_WIFI_H
+#define FAKE_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum { WL_IDLE_STATUS = 0, WL_DISCONNECTED = 6, WL_CONNECTED = 3 } wl_status_t;
+
+class IPAddress {};
+
+class Client : public Stream {
+ public:
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual uint8_t connected() = 0;
+  virtual void stop() = 0;
+};
+
+// A socket whose inbound bytes are whatever HTTPClient queued on it. Reads
+// hand out at most `chunk` bytes per available() so parsers see the body
+// arrive in pieces.
+class WiFiClient : public Client {
+ public:
+  WiFiClient() : pos(0), open(false), chunk(0) {}
+  int connect(const char *host, uint16_t port) override;
+  uint8_t connected() override { return open; }
+  void stop() override;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t *, size_t n) override { return n; }
+  using Print::write;
+  void setNoDelay(bool) {}
+
+  // Test side
+  void fakeQueue(const std::string &bytes) { inbound += bytes; }
+  void fakeSetChunk(size_t bytes) { chunk = bytes; }
+  size_t fakeUnread() const { return inbound.size() - pos; }
+
+ private:
+  std::string inbound;
+  size_t pos;
+  bool open;
+  size_t chunk;
+};
+
+class WiFiClass {
+ public:
+  wl_status_t status() { return WL_CONNECTED; }
+  void begin(const char *, const char *) {}
+  void mode(int) {}
+  void setSleep(bool) {}
+};
+
+extern WiFiClass WiFi;
+
+#endif
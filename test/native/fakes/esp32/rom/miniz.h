@@ -0,0 +1,49 @@
+#ifndef FAKE_MINIZ_H
+#define FAKE_MINIZ_H
+
+// The ROM inflater's interface, implemented on zlib (raw deflate). Only
+// the calls GzipStream makes are supported: a wrapping 32 KB output
+// window, one stream per tinfl_init().
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t mz_uint8;
+typedef uint32_t mz_uint32;
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+enum {
+  TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+  TINFL_FLAG_HAS_MORE_INPUT = 2,
+  TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4,
+  TINFL_FLAG_COMPUTE_ADLER32 = 8
+};
+
+typedef enum {
+  TINFL_STATUS_BAD_PARAM = -3,
+  TINFL_STATUS_ADLER32_MISMATCH = -2,
+  TINFL_STATUS_FAILED = -1,
+  TINFL_STATUS_DONE = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+// Same size as the ROM's decompressor, so allocations match the device.
+// The zlib state lives beside it, keyed by address.
+typedef struct {
+  mz_uint32 m_state;
+  mz_uint8 m_rest[10996];
+} tinfl_decompressor;
+
+#define tinfl_init(r) \
+  do {                \
+    (r)->m_state = 0; \
+  } while (0)
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *pIn_buf_next,
+                              size_t *pIn_buf_size, mz_uint8 *pOut_buf_start,
+                              mz_uint8 *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef FAKES_H
+#define FAKES_H
+
+// Test-side controls for the native fakes that have no device counterpart
+
+#include <Arduino.h>
+#include <string>
+
+#ifndef TEST_FIXTURE_DIR
+#define TEST_FIXTURE_DIR "test/fixtures"
+#endif
+
+// Everything written to Serial since the last clear
+std::string fakeSerialOutput();
+void fakeSerialClear();
+
+// The native env builds the real src/log.cpp, whose drain task writes to
+// the fake Serial once a test has called logBegin(). These wait for it
+// with logFlush(). Lines written since the last reset:
+uint32_t fakeLogLines();
+// Text of line `i`, without its "[I] " level tag and newline
+std::string fakeLogLine(uint32_t i);
+void fakeLogReset();
+
+// Puts a file on the fake SD card, replacing any earlier one
+void fakeSdPut(const char *path, const std::string &bytes, time_t mtime = 1700000000);
+void fakeSdClear();
+
+// Contents of a file under test/fixtures; empty if it cannot be read
+std::string fixtureRead(const char *name);
+
+// Monotonic nanoseconds for the benchmarks
+uint64_t fakeNanos();
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef FAKE_FREERTOS_H
+#define FAKE_FREERTOS_H
+
+// FreeRTOS on host threads: a task is a detached std::thread, notifications
+// and semaphores are counters under a condition variable. One tick is a
+// millisecond.
+
+#include <stdint.h>
+
+typedef void *TaskHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY 0
+#define tskNO_AFFINITY 0x7fffffff
+#define configMAX_PRIORITIES 25
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef FAKE_FREERTOS_SEMPHR_H
+#define FAKE_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+// Not priority-inheriting or owner-checked; a binary semaphore that starts given
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
+
+#endif
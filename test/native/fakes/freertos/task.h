@@ -0,0 +1,18 @@
+#ifndef FAKE_FREERTOS_TASK_H
+#define FAKE_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *created,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+BaseType_t xPortGetCoreID();
+
+#endif
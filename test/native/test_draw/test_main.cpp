@@ -0,0 +1,256 @@
+#include <Arduino.h>
+#include <SD.h>
+#include <TFT_eSPI.h>
+#include <unity.h>
+#include "draw.h"
+#include "imagecache.h"
+#include "fakes.h"
+
+// Draws synthetic assets through the real decode path into the fake panel,
+// then checks the pixels and that spiStats() agrees with the traffic the
+// driver generated. TFT_PNG_DIR=<dir> saves each frame for a look.
+
+static uint8_t patternR(int x, int y) { return x * 7 + y; }
+static uint8_t patternG(int x, int y) { return y * 5; }
+static uint8_t patternB(int x, int y) { return (x ^ y) * 3; }
+
+static uint16_t patternColor(int x, int y) {
+  return ((patternR(x, y) & 0xF8) << 8) | ((patternG(x, y) & 0xFC) << 3) | (patternB(x, y) >> 3);
+}
+
+static void put16(std::string &s, uint16_t v) {
+  s += (char)(v & 0xFF);
+  s += (char)(v >> 8);
+}
+
+static void put32(std::string &s, uint32_t v) {
+  put16(s, v & 0xFFFF);
+  put16(s, v >> 16);
+}
+
+// 24-bit uncompressed BMP of the test pattern
+static std::string makeBmp(int w, int h, bool bottomUp) {
+  uint32_t rowSize = (w * 3 + 3) & ~3;
+  std::string s = "BM";
+  put32(s, 54 + rowSize * h);
+  put32(s, 0);
+  put32(s, 54);
+  put32(s, 40);
+  put32(s, w);
+  put32(s, bottomUp ? h : -h);
+  put16(s, 1);
+  put16(s, 24);
+  put32(s, 0);
+  put32(s, rowSize * h);
+  put32(s, 2835);
+  put32(s, 2835);
+  put32(s, 0);
+  put32(s, 0);
+  for (int i = 0; i < h; ++i) {
+    int y = bottomUp ? h - 1 - i : i;
+    std::string row;
+    for (int x = 0; x < w; ++x) {
+      row += (char)patternB(x, y);
+      row += (char)patternG(x, y);
+      row += (char)patternR(x, y);
+    }
+    row.resize(rowSize, '\0');
+    s += row;
+  }
+  return s;
+}
+
+// Native asset of the test pattern; pixels equal to `key` are written as key
+static std::string makeRaw(int w, int h, int keyEvery = 0, uint16_t key = 0) {
+  RawHeader header = {};
+  memcpy(header.magic, RAW_MAGIC, 4);
+  header.width = w;
+  header.height = h;
+  header.format = RAW_FORMAT_RGB565_BE;
+  std::string s((const char *)&header, sizeof header);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      uint16_t c = keyEvery && (x + y) % keyEvery == 0 ? key : patternColor(x, y);
+      s += (char)(c >> 8);
+      s += (char)(c & 0xFF);
+    }
+  }
+  return s;
+}
+
+static void dumpFrame(const char *name) {
+  const char *dir = getenv("TFT_PNG_DIR");
+  if (!dir) return;
+  std::string path = std::string(dir) + "/" + name + ".png";
+  TEST_ASSERT_TRUE(tft.fakeWritePng(path.c_str()));
+}
+
+static void assertPattern(int x0, int y0, int w, int h) {
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      if (tft.fakePixel(x0 + x, y0 + y) != patternColor(x, y)) {
+        char msg[64];
+        snprintf(msg, sizeof msg, "pixel %d,%d", x, y);
+        TEST_ASSERT_EQUAL_HEX16_MESSAGE(patternColor(x, y), tft.fakePixel(x0 + x, y0 + y), msg);
+      }
+    }
+  }
+}
+
+// The draw code's counters against what the fake driver saw, from a
+// starting point taken before the draw
+static void assertStatsMatch(const SpiStats &before) {
+  SpiStats after = spiStats();
+  FakeBusStats bus = tft.fakeStats();
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(bus.pixelBytes, after.bytes - before.bytes, "bytes");
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(bus.windows, after.windows - before.windows, "windows");
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(bus.transactions, after.transactions - before.transactions,
+                                   "transactions");
+}
+
+void setUp() {
+  clearColorKey();
+  tft.setRotation(0);
+  tft.fillScreen(TFT_BLACK);
+  tft.fakeReset();
+}
+
+void tearDown() {}
+
+static void test_raw_image() {
+  fakeSdPut("/raw.565", makeRaw(40, 30));
+  SpiStats before = spiStats();
+  drawRaw("/raw.565", 10, 20);
+  dumpFrame("raw");
+  assertPattern(10, 20, 40, 30);
+  assertStatsMatch(before);
+  TEST_ASSERT_EQUAL_UINT32(40 * 30 * 2, tft.fakeStats().pixelBytes);
+}
+
+static void test_bmp_top_down() {
+  fakeSdPut("/down.bmp", makeBmp(33, 21, false));
+  SpiStats before = spiStats();
+  drawBmp("/down.bmp", 5, 7);
+  dumpFrame("bmp_top_down");
+  assertPattern(5, 7, 33, 21);
+  assertStatsMatch(before);
+}
+
+static void test_bmp_bottom_up_in_each_rotation() {
+  fakeSdPut("/up.bmp", makeBmp(37, 19, true));
+  for (uint8_t r = 0; r < 4; ++r) {
+    tft.setRotation(r);
+    tft.fillScreen(TFT_BLACK);
+    tft.fakeReset();
+    // Moving the image each time keeps the cache from serving it
+    fakeSdPut("/up.bmp", makeBmp(37, 19, true), 1700000000 + r);
+    SpiStats before = spiStats();
+    drawBmp("/up.bmp", 3 + r, 11);
+    char name[24];
+    snprintf(name, sizeof name, "bmp_bottom_up_r%u", r);
+    dumpFrame(name);
+    assertPattern(3 + r, 11, 37, 19);
+    assertStatsMatch(before);
+    TEST_ASSERT_EQUAL_UINT8(r, tft.getRotation());
+  }
+}
+
+static void test_cache_hit_is_one_window() {
+  fakeSdPut("/again.bmp", makeBmp(16, 16, true));
+  drawBmp("/again.bmp", 0, 0);
+  tft.fillScreen(TFT_BLACK);
+  tft.fakeReset();
+  ImageCacheStats cacheBefore = imageCacheStats();
+  SpiStats before = spiStats();
+  drawBmp("/again.bmp", 100, 200);
+  TEST_ASSERT_EQUAL_UINT32(cacheBefore.hits + 1, imageCacheStats().hits);
+  assertPattern(100, 200, 16, 16);
+  assertStatsMatch(before);
+  TEST_ASSERT_EQUAL_UINT32(1, spiStats().windows - before.windows);
+}
+
+static void test_color_key_skips_keyed_pixels() {
+  const uint16_t key = TFT_MAGENTA;
+  fakeSdPut("/keyed.565", makeRaw(24, 12, 5, key));
+  tft.fillScreen(TFT_NAVY);
+  tft.fakeReset();
+  setColorKey(key);
+  SpiStats before = spiStats();
+  drawRaw("/keyed.565", 50, 60);
+  dumpFrame("color_key");
+  for (int y = 0; y < 12; ++y) {
+    for (int x = 0; x < 24; ++x) {
+      uint16_t want = (x + y) % 5 == 0 ? TFT_NAVY : patternColor(x, y);
+      TEST_ASSERT_EQUAL_HEX16(want, tft.fakePixel(50 + x, 60 + y));
+    }
+  }
+  assertStatsMatch(before);
+}
+
+static void test_sprite_from_atlas() {
+  std::string atlas = makeRaw(32, 16);
+  RawHeader header;
+  memcpy(&header, atlas.data(), sizeof header);
+  header.spriteCount = 1;
+  SpriteEntry entry = {};
+  strcpy(entry.name, "fish");
+  entry.x = 8;
+  entry.y = 4;
+  entry.w = 12;
+  entry.h = 9;
+  std::string file((const char *)&header, sizeof header);
+  file.append((const char *)&entry, sizeof entry);
+  file.append(atlas, sizeof header, std::string::npos);
+  fakeSdPut("/atlas.565", file);
+
+  SpriteAtlas a;
+  TEST_ASSERT_TRUE(loadAtlas(a, "/atlas.565"));
+  SpiStats before = spiStats();
+  TEST_ASSERT_TRUE(drawSprite(a, "fish", 70, 80));
+  closeAtlas(a);
+  for (int y = 0; y < 9; ++y) {
+    for (int x = 0; x < 12; ++x) {
+      TEST_ASSERT_EQUAL_HEX16(patternColor(8 + x, 4 + y), tft.fakePixel(70 + x, 80 + y));
+    }
+  }
+  assertStatsMatch(before);
+}
+
+// Prints how often each side of the decode ring waited on a full-width
+// image. The fake card does not contend for the panel's bus, so these show
+// the ring's scheduling rather than the device's SPI sharing.
+static void test_decode_stalls() {
+  fakeSdPut("/wide.bmp", makeBmp(320, 240, false));
+  DecodeStats before = decodeStats();
+  drawBmp("/wide.bmp", 0, 0);
+  assertPattern(0, 0, 320, 240);
+  DecodeStats after = decodeStats();
+  char msg[96];
+  snprintf(msg, sizeof msg, "SD_SHARES_TFT_SPI=%d, 30 blocks: producer stalls %u, consumer stalls %u",
+           SD_SHARES_TFT_SPI, (unsigned)(after.producerStalls - before.producerStalls),
+           (unsigned)(after.consumerStalls - before.consumerStalls));
+  TEST_MESSAGE(msg);
+}
+
+static void test_bus_time_estimate() {
+  // 320x480 full screen plus one window: (307200 + 11) bytes at 40 MHz
+  SpiStats full = { 320 * 480 * 2, 1, 1 };
+  TEST_ASSERT_EQUAL_UINT32(61442, spiBusMicros(full));
+  SpiStats none = { 0, 0, 0 };
+  TEST_ASSERT_EQUAL_UINT32(0, spiBusMicros(none));
+}
+
+int main() {
+  tft.init();
+  drawInit();
+  UNITY_BEGIN();
+  RUN_TEST(test_raw_image);
+  RUN_TEST(test_bmp_top_down);
+  RUN_TEST(test_bmp_bottom_up_in_each_rotation);
+  RUN_TEST(test_cache_hit_is_one_window);
+  RUN_TEST(test_color_key_skips_keyed_pixels);
+  RUN_TEST(test_sprite_from_atlas);
+  RUN_TEST(test_decode_stalls);
+  RUN_TEST(test_bus_time_estimate);
+  return UNITY_END();
+}
@@ -0,0 +1,89 @@
+#include <Arduino.h>
+#include <SD.h>
+#include <TFT_eSPI.h>
+#include <unity.h>
+#include "draw.h"
+#include "log.h"
+#include "fakes.h"
+
+// In a release build nothing in the BMP row loop may reach the log: the
+// trace calls must compile out and the warnings only fire on bad reads.
+// The native env builds at the release level, and every message queued
+// comes out of the drain task as one line.
+
+static_assert(LOG_LEVEL == LOG_LEVEL_INFO, "the native env should build at the release level");
+
+static void put16(std::string &s, uint16_t v) {
+  s += (char)(v & 0xFF);
+  s += (char)(v >> 8);
+}
+
+static void put32(std::string &s, uint32_t v) {
+  put16(s, v & 0xFFFF);
+  put16(s, v >> 16);
+}
+
+static std::string makeBmp(int w, int h, bool bottomUp) {
+  uint32_t rowSize = (w * 3 + 3) & ~3;
+  std::string s = "BM";
+  put32(s, 54 + rowSize * h);
+  put32(s, 0);
+  put32(s, 54);
+  put32(s, 40);
+  put32(s, w);
+  put32(s, bottomUp ? h : -h);
+  put16(s, 1);
+  put16(s, 24);
+  put32(s, 0);
+  put32(s, rowSize * h);
+  put32(s, 2835);
+  put32(s, 2835);
+  put32(s, 0);
+  put32(s, 0);
+  for (int i = 0; i < h * (int)rowSize; ++i) s += (char)(i * 13);
+  return s;
+}
+
+// Log lines written for one uncached draw of a w x h BMP
+static uint32_t linesForDraw(const char *path, int w, int h, bool bottomUp) {
+  fakeSdPut(path, makeBmp(w, h, bottomUp));
+  fakeLogReset();
+  drawBmp(path, 0, 0);
+  return fakeLogLines();
+}
+
+void setUp() {
+  tft.fillScreen(TFT_BLACK);
+}
+
+void tearDown() {}
+
+static void test_lines_do_not_grow_with_rows() {
+  for (int bottomUp = 0; bottomUp < 2; ++bottomUp) {
+    uint32_t oneRow = linesForDraw(bottomUp ? "/one-up.bmp" : "/one.bmp", 64, 1, bottomUp);
+    uint32_t manyRows = linesForDraw(bottomUp ? "/tall-up.bmp" : "/tall.bmp", 64, 300, bottomUp);
+    TEST_ASSERT_EQUAL_UINT32(oneRow, manyRows);
+  }
+}
+
+// What is left is the per-image summary, logged after the rows are done
+static void test_only_the_summary_is_logged() {
+  linesForDraw("/summary.bmp", 50, 120, true);
+  const char *expected[] = { "BMP ", "SPI ", "Image cache ", "Decode stalls " };
+  TEST_ASSERT_EQUAL_UINT32(sizeof expected / sizeof expected[0], fakeLogLines());
+  for (uint32_t i = 0; i < fakeLogLines(); ++i) {
+    std::string line = fakeLogLine(i);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, line.compare(0, strlen(expected[i]), expected[i]),
+                                  line.c_str());
+  }
+}
+
+int main() {
+  logBegin(115200);
+  tft.init();
+  drawInit();
+  UNITY_BEGIN();
+  RUN_TEST(test_lines_do_not_grow_with_rows);
+  RUN_TEST(test_only_the_summary_is_logged);
+  return UNITY_END();
+}
@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "forecast.h"
+#include "fakes.h"
+
+// bestWindow()'s sliding sum against summing every candidate window
+
+// Earliest start of the highest-summing window in [from, hours), or -1
+static int bruteBestWindow(const uint8_t *scores, uint8_t hours, uint8_t from, uint8_t window,
+                           uint16_t &total) {
+  int best = -1;
+  for (int start = from; window && start + window <= hours; ++start) {
+    uint16_t sum = 0;
+    for (int i = start; i < start + window; ++i) sum += scores[i];
+    if (best < 0 || sum > total) {
+      best = start;
+      total = sum;
+    }
+  }
+  return best;
+}
+
+static void fillScores(uint8_t *scores, int range, unsigned seed) {
+  srand(seed);
+  for (int i = 0; i < FORECAST_HOURS; ++i) scores[i] = rand() % range;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// Every start and window size over every forecast length, with scores
+// spread out and with few distinct values so ties are common
+static void test_matches_brute_force() {
+  uint8_t scores[FORECAST_HOURS];
+  const int ranges[] = { 101, 3, 1 };
+  for (int range : ranges) {
+    for (unsigned seed = 0; seed < 8; ++seed) {
+      fillScores(scores, range, seed * 7 + range);
+      for (int hours = 0; hours <= FORECAST_HOURS; ++hours) {
+        for (int from = 0; from <= hours; ++from) {
+          for (int window = 0; window <= 12; ++window) {
+            uint16_t want = 0xFFFF, got = 0xFFFF;
+            int wantStart = bruteBestWindow(scores, hours, from, window, want);
+            int gotStart = bestWindow(scores, hours, from, window, got);
+            char msg[64];
+            snprintf(msg, sizeof msg, "range %d hours %d from %d window %d", range, hours, from,
+                     window);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(wantStart, gotStart, msg);
+            if (wantStart >= 0) TEST_ASSERT_EQUAL_UINT16_MESSAGE(want, got, msg);
+          }
+        }
+      }
+    }
+  }
+}
+
+// The whole 72-hour forecast at the largest score, where sums come
+// closest to overflowing
+static void test_full_scores() {
+  uint8_t scores[FORECAST_HOURS];
+  memset(scores, 100, sizeof scores);
+  uint16_t total;
+  TEST_ASSERT_EQUAL_INT(0, bestWindow(scores, FORECAST_HOURS, 0, FORECAST_HOURS, total));
+  TEST_ASSERT_EQUAL_UINT16(100 * FORECAST_HOURS, total);
+}
+
+static void test_timing() {
+  const int rounds = 100000;
+  uint8_t scores[FORECAST_HOURS];
+  fillScores(scores, 101, 1);
+  volatile int sink = 0;
+  uint16_t total;
+  uint64_t t0 = fakeNanos();
+  for (int r = 0; r < rounds; ++r) {
+    sink += bruteBestWindow(scores, FORECAST_HOURS, r % 24, 3, total);
+  }
+  uint64_t t1 = fakeNanos();
+  for (int r = 0; r < rounds; ++r) sink += bestWindow(scores, FORECAST_HOURS, r % 24, 3, total);
+  uint64_t t2 = fakeNanos();
+  char msg[96];
+  snprintf(msg, sizeof msg, "3-hour window over 72 slots: brute force %.1f ns, bestWindow %.1f ns",
+           (t1 - t0) / (double)rounds, (t2 - t1) / (double)rounds);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_brute_force);
+  RUN_TEST(test_full_scores);
+  RUN_TEST(test_timing);
+  return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <thread>
+#include "log.h"
+#include "fakes.h"
+
+// The real ring logger: messages queued before logBegin(), wrapping the
+// ring many times over, string arguments at the slot's text limit and
+// several producers at once. The drain task runs on the fake FreeRTOS.
+
+static std::string repeat(char c, size_t n) {
+  return std::string(n, c);
+}
+
+void setUp() {
+  fakeLogReset();
+}
+
+void tearDown() {}
+
+// With no drain task yet the ring fills, then the rest are counted as
+// dropped; the drain writes the queued ones in order and reports the drops
+static void test_full_ring_drops_and_reports() {
+  for (int i = 0; i < LOG_RING_SLOTS + 6; ++i) LOG_INFO("early %d", i);
+  TEST_ASSERT_EQUAL_UINT32(6, logDropped());
+
+  logBegin(115200);
+  TEST_ASSERT_EQUAL_UINT32(LOG_RING_SLOTS + 1, fakeLogLines());
+  for (int i = 0; i < LOG_RING_SLOTS; ++i) {
+    std::string want = "early " + std::to_string(i);
+    TEST_ASSERT_EQUAL_STRING(want.c_str(), fakeLogLine(i).c_str());
+  }
+  std::string out = fakeSerialOutput();
+  std::string first = out.substr(0, out.find('\n') + 1);
+  std::string last = out.substr(out.rfind('['));
+  TEST_ASSERT_EQUAL_STRING("[I] early 0\n", first.c_str());
+  TEST_ASSERT_EQUAL_STRING("[W] log ring full, 6 messages dropped\n", last.c_str());
+}
+
+// 320 messages in batches that do not divide the ring: every slot is
+// reused five times and batches straddle the wrap
+static void test_wraparound_keeps_order() {
+  uint32_t dropsBefore = logDropped();
+  int next = 0;
+  for (int batch = 0; batch < 8; ++batch) {
+    for (int i = 0; i < 40; ++i, ++next) LOG_WARN("seq %d of %s", next, "wrap");
+    TEST_ASSERT_EQUAL_UINT32(40, fakeLogLines());
+    for (int i = 0; i < 40; ++i) {
+      std::string want = "seq " + std::to_string(next - 40 + i) + " of wrap";
+      TEST_ASSERT_EQUAL_STRING(want.c_str(), fakeLogLine(i).c_str());
+    }
+    fakeLogReset();
+  }
+  TEST_ASSERT_EQUAL_UINT32(dropsBefore, logDropped());
+}
+
+// Strings share LOG_TEXT_BYTES per message, terminators included
+static void test_strings_truncated_to_slot() {
+  std::string longText = repeat('a', 60);
+  LOG_INFO("%s", longText.c_str());
+  std::string half = repeat('b', 30);
+  LOG_INFO("%s|%s", half.c_str(), half.c_str());
+  std::string most = repeat('c', 40);
+  LOG_INFO("%s|%s|%s", most.c_str(), "defghijk", "lost");
+  // The copy is taken when queued, so the caller's buffer may change
+  char temp[8] = "before";
+  LOG_INFO("%s", temp);
+  strcpy(temp, "after");
+
+  TEST_ASSERT_EQUAL_UINT32(4, fakeLogLines());
+  std::string want = repeat('a', LOG_TEXT_BYTES - 1);
+  TEST_ASSERT_EQUAL_STRING(want.c_str(), fakeLogLine(0).c_str());
+  // 31 bytes for the first, 16 characters and a terminator left
+  want = half + "|" + repeat('b', 16);
+  TEST_ASSERT_EQUAL_STRING(want.c_str(), fakeLogLine(1).c_str());
+  // 41 bytes, then 6 characters, then no room at all
+  want = most + "|defghi|";
+  TEST_ASSERT_EQUAL_STRING(want.c_str(), fakeLogLine(2).c_str());
+  TEST_ASSERT_EQUAL_STRING("before", fakeLogLine(3).c_str());
+}
+
+static void test_argument_types() {
+  String location("Lincoln,NE");
+  LOG_ERROR("%s: %.1f F, %u bytes, %ld ms", location, 85.5, 3000000000UL, -7L);
+  LOG_ERROR("%d%% %5.2f|%-4d|", 42, 7, 3);
+  LOG_DEBUG("compiled out at this level %d", 1);
+  TEST_ASSERT_EQUAL_UINT32(2, fakeLogLines());
+  TEST_ASSERT_EQUAL_STRING("Lincoln,NE: 85.5 F, 3000000000 bytes, -7 ms", fakeLogLine(0).c_str());
+  // An int passed to a float conversion is converted rather than misread
+  TEST_ASSERT_EQUAL_STRING("42%  7.00|3   |", fakeLogLine(1).c_str());
+  std::string tag = fakeSerialOutput().substr(0, 4);
+  TEST_ASSERT_EQUAL_STRING("[E] ", tag.c_str());
+}
+
+// Four producers racing for slots; one ring's worth, so none is dropped
+// even if the drain does not get a turn
+static void test_concurrent_producers() {
+  const int threads = 4;
+  const int each = LOG_RING_SLOTS / threads;
+  uint32_t dropsBefore = logDropped();
+  std::thread producers[threads];
+  for (int t = 0; t < threads; ++t) {
+    producers[t] = std::thread([t] {
+      for (int i = 0; i < each; ++i) LOG_INFO("t%d n%d", t, i);
+    });
+  }
+  for (std::thread &p : producers) p.join();
+
+  TEST_ASSERT_EQUAL_UINT32(threads * each, fakeLogLines());
+  TEST_ASSERT_EQUAL_UINT32(dropsBefore, logDropped());
+  int seen[threads] = {};
+  for (uint32_t i = 0; i < fakeLogLines(); ++i) {
+    int t, n;
+    TEST_ASSERT_EQUAL_INT(2, sscanf(fakeLogLine(i).c_str(), "t%d n%d", &t, &n));
+    // Each producer's messages come out in the order it queued them
+    TEST_ASSERT_EQUAL_INT(seen[t]++, n);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  // Must run first: it is the one that starts the drain task
+  RUN_TEST(test_full_ring_drops_and_reports);
+  RUN_TEST(test_wraparound_keeps_order);
+  RUN_TEST(test_strings_truncated_to_slot);
+  RUN_TEST(test_argument_types);
+  RUN_TEST(test_concurrent_producers);
+  return UNITY_END();
+}
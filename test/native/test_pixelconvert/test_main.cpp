@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <PixelConvert.h>
+
+// The converter against the RGB565 packing written out longhand, for every
+// run length and source alignment
+
+#define MAX_RUN 69
+
+// Wire bytes of one BMP pixel: RGB565 high byte first
+static void referencePixel(const uint8_t *bgr, uint8_t out[2]) {
+  uint16_t c = ((bgr[2] & 0xF8) << 8) | ((bgr[1] & 0xFC) << 3) | (bgr[0] >> 3);
+  out[0] = c >> 8;
+  out[1] = c & 0xFF;
+}
+
+static void referenceConvert(const uint8_t *src, uint8_t *dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) referencePixel(src + 3 * i, dst + 2 * i);
+}
+
+static void fillSource(uint8_t *src, size_t bytes, unsigned seed) {
+  srand(seed);
+  for (size_t i = 0; i < bytes; ++i) src[i] = rand();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_every_length_and_offset() {
+  uint8_t src[3 * MAX_RUN + 4];
+  uint16_t dst[MAX_RUN + 2];
+  uint8_t want[2 * MAX_RUN];
+  for (size_t count = 0; count <= MAX_RUN; ++count) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      fillSource(src, sizeof src, count * 4 + offset);
+      referenceConvert(src + offset, want, count);
+      // A guard pixel past the end must survive
+      memset(dst, 0xA5, sizeof dst);
+      convertBgr888ToRgb565(src + offset, dst, count);
+      char msg[48];
+      snprintf(msg, sizeof msg, "count %u offset %u", (unsigned)count, (unsigned)offset);
+      if (count) TEST_ASSERT_EQUAL_MEMORY_MESSAGE(want, dst, 2 * count, msg);
+      TEST_ASSERT_EQUAL_HEX16_MESSAGE(0xA5A5, dst[count], msg);
+    }
+  }
+}
+
+static void test_inline_helper_matches_reference() {
+  for (int r = 0; r < 256; r += 3) {
+    for (int g = 0; g < 256; g += 5) {
+      for (int b = 0; b < 256; b += 7) {
+        uint8_t bgr[3] = { (uint8_t)b, (uint8_t)g, (uint8_t)r };
+        uint8_t want[2];
+        referencePixel(bgr, want);
+        uint16_t px = rgb565Swapped(r, g, b);
+        TEST_ASSERT_EQUAL_MEMORY(want, &px, 2);
+      }
+    }
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_length_and_offset);
+  RUN_TEST(test_inline_helper_matches_reference);
+  return UNITY_END();
+}
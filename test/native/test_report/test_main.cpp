@@ -0,0 +1,212 @@
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <unity.h>
+#include <vector>
+#include "report.h"
+#include "scoremodel.h"
+#include "weatherclient.h"
+#include "fakes.h"
+
+extern TFT_eSPI tft;
+
+// The report drawn into the fake panel: the score meter, the text of a
+// report and its error screens, and a refresh drawn over a longer report
+// leaving the same frame as one drawn on a blank screen.
+
+// 2024-06-19 08:00 CDT
+static const time_t now = 1718773200 + 8 * 3600;
+
+static SolunarCache noSolunar;
+
+static WeatherSample goodSample() {
+  WeatherSample w;
+  sampleClear(w);
+  w.updatedEpoch = now - 600;
+  w.tempDeciF = 720;
+  w.pressureCentiIn = 2998;
+  w.windDeciMph = 60;
+  w.cloud = 50;
+  w.rainChance = 10;
+  w.sunriseMin = 5 * 60 + 55;
+  w.sunsetMin = 21 * 60 + 2;
+  w.windDir = windDirFromText("SSW");
+  return w;
+}
+
+// 24 slots from local midnight, each hour a little warmer than the last
+static void makeForecast(HourlyForecast &f) {
+  forecastClear(f);
+  f.startEpoch = 1718773200;
+  f.hours = 24;
+  for (uint8_t i = 0; i < f.hours; ++i) {
+    f.tempDeciF[i] = 600 + i * 5;
+    f.pressureCentiIn[i] = 2998;
+    f.windDeciMph[i] = 50;
+    f.cloud[i] = 50;
+    f.rainChance[i] = 10;
+    f.solunar[i] = SAMPLE_NO_PERCENT;
+  }
+}
+
+static std::vector<uint16_t> snapshot() {
+  std::vector<uint16_t> frame;
+  for (int32_t y = 0; y < tft.height(); ++y) {
+    for (int32_t x = 0; x < tft.width(); ++x) frame.push_back(tft.fakePixel(x, y));
+  }
+  return frame;
+}
+
+static bool hasText(const char *needle) {
+  return tft.fakeText().find(needle) != std::string::npos;
+}
+
+void setUp() {
+  setenv("TZ", "CST6CDT,M3.2.0,M11.1.0", 1);
+  tzset();
+  noSolunar.firstDay = -1;
+  tft.fillScreen(TFT_BLACK);
+  tft.setTextColor(TFT_WHITE, TFT_BLACK);
+  tft.setTextSize(2);
+  tft.fakeReset();
+  reportInit();
+  reportRestart();
+}
+
+void tearDown() {}
+
+static void test_fish_rating() {
+  TEST_ASSERT_EQUAL_STRING("Excellent", fishRating(80));
+  TEST_ASSERT_EQUAL_STRING("Good", fishRating(79));
+  TEST_ASSERT_EQUAL_STRING("Good", fishRating(60));
+  TEST_ASSERT_EQUAL_STRING("Fair", fishRating(40));
+  TEST_ASSERT_EQUAL_STRING("Poor", fishRating(39));
+  TEST_ASSERT_EQUAL_STRING("Poor", fishRating(0));
+}
+
+static void test_meter_bar_and_outline() {
+  int16_t w = tft.width();
+  tft.fillRect(0, 100, w, 2 * tft.fontHeight(), TFT_BLUE);
+  tft.setCursor(0, 100);
+  rectMeter(50);
+  int bar = map(50, 0, 100, 0, w - 20);
+  // Outline
+  TEST_ASSERT_EQUAL_HEX16(TFT_WHITE, tft.fakePixel(10, 110));
+  TEST_ASSERT_EQUAL_HEX16(TFT_WHITE, tft.fakePixel(w - 11, 129));
+  // Bar, then the empty rest of the meter
+  TEST_ASSERT_EQUAL_HEX16(TFT_ORANGE, tft.fakePixel(11, 120));
+  TEST_ASSERT_EQUAL_HEX16(TFT_ORANGE, tft.fakePixel(9 + bar, 120));
+  TEST_ASSERT_EQUAL_HEX16(TFT_BLACK, tft.fakePixel(10 + bar, 120));
+  // Both text rows are cleared around the meter
+  TEST_ASSERT_EQUAL_HEX16(TFT_BLACK, tft.fakePixel(0, 100));
+  TEST_ASSERT_EQUAL_HEX16(TFT_BLACK, tft.fakePixel(5, 120));
+  TEST_ASSERT_EQUAL_HEX16(TFT_BLACK, tft.fakePixel(w - 5, 120));
+  TEST_ASSERT_EQUAL_HEX16(TFT_BLACK, tft.fakePixel(w / 2, 100 + 2 * tft.fontHeight() - 1));
+}
+
+static void test_meter_colors() {
+  const struct { int score; uint16_t color; } steps[] = {
+    { 100, TFT_GREEN }, { 80, TFT_GREEN }, { 79, TFT_YELLOW }, { 60, TFT_YELLOW },
+    { 59, TFT_ORANGE }, { 40, TFT_ORANGE }, { 39, TFT_RED }, { 1, TFT_RED },
+  };
+  for (const auto &s : steps) {
+    tft.setCursor(0, 100);
+    rectMeter(s.score);
+    char msg[16];
+    snprintf(msg, sizeof msg, "score %d", s.score);
+    TEST_ASSERT_EQUAL_HEX16_MESSAGE(s.color, tft.fakePixel(11, 120), msg);
+  }
+  // Nothing of the bar at zero
+  tft.setCursor(0, 100);
+  rectMeter(0);
+  TEST_ASSERT_EQUAL_HEX16(TFT_BLACK, tft.fakePixel(11, 120));
+}
+
+static void test_report_text() {
+  showWeather("Lincoln", 200, goodSample(), SPECIES_BIT(SPECIES_CATFISH), noSolunar, now);
+  TEST_ASSERT_TRUE(hasText("Location: Lincoln\n"));
+  TEST_ASSERT_TRUE(hasText("Updated: 10 min ago\n"));
+  TEST_ASSERT_TRUE(hasText("Temp: 72.0 F\n"));
+  TEST_ASSERT_TRUE(hasText("Wind: 6 mph SSW\n"));
+  TEST_ASSERT_TRUE(hasText("Sunrise: 05:55 AM\n"));
+  TEST_ASSERT_TRUE(hasText("Fishing Score: "));
+  TEST_ASSERT_TRUE(hasText("Rating: "));
+  // No forecast, no best window
+  TEST_ASSERT_FALSE(hasText("Best: "));
+}
+
+static void test_species_side_by_side() {
+  uint8_t both = SPECIES_BIT(SPECIES_CATFISH) | SPECIES_BIT(SPECIES_BASS);
+  showWeather("Lincoln", 200, goodSample(), both, noSolunar, now);
+  char line[32];
+  snprintf(line, sizeof line, "%s %d | %s %d\r\n", speciesLabel(SPECIES_CATFISH),
+           scoreSample(goodSample(), SPECIES_CATFISH), speciesLabel(SPECIES_BASS),
+           scoreSample(goodSample(), SPECIES_BASS));
+  TEST_ASSERT_TRUE_MESSAGE(hasText(line), line);
+  TEST_ASSERT_FALSE(hasText("Fishing Score: "));
+}
+
+static void test_best_window() {
+  static HourlyForecast f;
+  makeForecast(f);
+  showWeather("Lincoln", 200, goodSample(), SPECIES_BIT(SPECIES_CATFISH), noSolunar, now, &f);
+  TEST_ASSERT_TRUE(hasText("Best: "));
+  // Only hours still ahead are searched
+  TEST_ASSERT_FALSE(hasText("Best: Wed 12AM"));
+}
+
+static void test_error_screens() {
+  WeatherSample w = goodSample();
+  showWeather("Lincoln", WEATHER_PARSE_FAILED, w, 1, noSolunar, now);
+  TEST_ASSERT_TRUE(hasText("PARSE ERROR"));
+
+  tft.fakeReset();
+  w.apiError = 2006;
+  showWeather("Lincoln", 200, w, 1, noSolunar, now);
+  TEST_ASSERT_TRUE(hasText("API error: "));
+  TEST_ASSERT_FALSE(hasText("Location: "));
+
+  tft.fakeReset();
+  showWeather("Lincoln", -1, goodSample(), 1, noSolunar, now);
+  TEST_ASSERT_TRUE(hasText("HTTP error -1\n"));
+}
+
+// Two locations, then one: the second location's block and anything below
+// it must be gone, as if the screen had been cleared first
+static void test_redraw_over_longer_report() {
+  static HourlyForecast f;
+  makeForecast(f);
+  uint8_t mask = SPECIES_BIT(SPECIES_CATFISH);
+  reportInit();
+  tft.fillScreen(TFT_BLACK);
+  reportRestart();
+  showWeather("Lincoln", 200, goodSample(), mask, noSolunar, now, &f);
+  reportFinish();
+  std::vector<uint16_t> fresh = snapshot();
+
+  reportRestart();
+  WeatherSample other = goodSample();
+  other.tempDeciF = 455;
+  other.windDeciMph = 180;
+  showWeather("A much longer location name", 200, other, mask, noSolunar, now, &f);
+  showWeather("Omaha", 200, other, mask, noSolunar, now, &f);
+  reportFinish();
+
+  reportRestart();
+  showWeather("Lincoln", 200, goodSample(), mask, noSolunar, now, &f);
+  reportFinish();
+  TEST_ASSERT_TRUE(snapshot() == fresh);
+}
+
+int main() {
+  scoreInit();
+  UNITY_BEGIN();
+  RUN_TEST(test_fish_rating);
+  RUN_TEST(test_meter_bar_and_outline);
+  RUN_TEST(test_meter_colors);
+  RUN_TEST(test_report_text);
+  RUN_TEST(test_species_side_by_side);
+  RUN_TEST(test_best_window);
+  RUN_TEST(test_error_screens);
+  RUN_TEST(test_redraw_over_longer_report);
+  return UNITY_END();
+}
@@ -0,0 +1,260 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "scoremodel.h"
+#include "fakes.h"
+
+// The band tables must reproduce the report's original scoring exactly,
+// float-versus-double comparisons included. fishScore() below is the
+// function they replaced, as it stood.
+
+int fishScore(int cloud,int wind_mph,float pressure,float temp_f,int rainChance) {
+  int rating = 0;
+
+      //Cloud ideal 80+
+      if (cloud >= 80){
+        rating += 20;
+      } else if (cloud >= 50 && cloud < 80){
+        rating += 10;
+      } else {
+        rating += 5;
+      }
+
+      //Wind ideal < 10
+      if (wind_mph <= 10.0){
+        rating += 20;
+      } else if (wind_mph > 10.0 && wind_mph <= 20.0){
+        rating += 10;
+      } else {
+        rating += 5;
+      }
+
+      //Pressure ideal
+      if (pressure >= 29.8 && pressure <= 30.2) {
+        rating += 20;
+      } else if (pressure < 29.6) {
+        rating += 5;
+      }
+
+      //Temp ideal 60-75 F
+      if (temp_f >= 60.0 && temp_f <= 75.0) {
+        rating += 20;
+      } else if (temp_f >= 50.0 || temp_f <= 85.0) {
+        rating += 10;
+      } else {
+        rating += 5;
+      }
+
+      //Rain
+      if (rainChance >= 0 && rainChance <= 30) {
+        rating += 20;
+      } else if (rainChance > 60) {
+        rating += 5;
+      }
+
+  return rating;
+}
+
+int fishScore(const WeatherSample &s) {
+  // Wind is scored in whole mph, truncated as it always has been
+  return fishScore(s.cloud, (int)sampleWindMph(s), samplePressureIn(s), sampleTempF(s),
+                   s.rainChance);
+}
+
+static WeatherSample baseline() {
+  WeatherSample s;
+  sampleClear(s);
+  s.cloud = 40;
+  s.rainChance = 10;
+  s.windDeciMph = 55;
+  s.pressureCentiIn = 2990;
+  s.tempDeciF = 655;
+  return s;
+}
+
+static void assertSame(const WeatherSample &s) {
+  if (scoreSample(s) == fishScore(s)) return;
+  char msg[96];
+  snprintf(msg, sizeof msg, "cloud %d wind %d pressure %d temp %d rain %d", s.cloud, s.windDeciMph,
+           s.pressureCentiIn, s.tempDeciF, s.rainChance);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(fishScore(s), scoreSample(s), msg);
+}
+
+void setUp() {
+  scoreInit();
+}
+
+void tearDown() {}
+
+// Both are a sum of independent per-factor points and stay under
+// SCORE_MAX, so sweeping each field over every value its type can hold,
+// with the others fixed, covers every combination.
+static void test_every_value_of_every_field() {
+  WeatherSample s = baseline();
+  assertSame(s);
+  for (int v = INT8_MIN; v <= INT8_MAX; ++v) {
+    s.cloud = v;
+    assertSame(s);
+  }
+  s = baseline();
+  for (int v = INT8_MIN; v <= INT8_MAX; ++v) {
+    s.rainChance = v;
+    assertSame(s);
+  }
+  s = baseline();
+  for (int v = INT16_MIN; v <= INT16_MAX; ++v) {
+    s.windDeciMph = v;
+    assertSame(s);
+  }
+  s = baseline();
+  for (int v = INT16_MIN; v <= INT16_MAX; ++v) {
+    s.pressureCentiIn = v;
+    assertSame(s);
+  }
+  s = baseline();
+  for (int v = INT16_MIN; v <= INT16_MAX; ++v) {
+    s.tempDeciF = v;
+    assertSame(s);
+  }
+}
+
+static void test_random_samples() {
+  srand(1);
+  WeatherSample s = baseline();
+  for (int i = 0; i < 1000000; ++i) {
+    s.cloud = rand() % 102 - 1;
+    s.rainChance = rand() % 102 - 1;
+    s.windDeciMph = rand() % 500 - 10;
+    s.pressureCentiIn = rand() % 800 + 2700;
+    s.tempDeciF = rand() % 1600 - 200;
+    assertSame(s);
+  }
+}
+
+// 29.80f is just below 29.8 and 30.20f just above 30.2, so neither end of
+// the ideal pressure band scores; 29.60f is not below 29.6
+static void test_pressure_edges_compare_float_to_double() {
+  WeatherSample s = baseline();
+  s.pressureCentiIn = 2990;
+  int ideal = scoreSample(s);
+  s.pressureCentiIn = 2980;
+  TEST_ASSERT_EQUAL_INT(ideal - 20, scoreSample(s));
+  s.pressureCentiIn = 2981;
+  TEST_ASSERT_EQUAL_INT(ideal, scoreSample(s));
+  s.pressureCentiIn = 3019;
+  TEST_ASSERT_EQUAL_INT(ideal, scoreSample(s));
+  s.pressureCentiIn = 3020;
+  TEST_ASSERT_EQUAL_INT(ideal - 20, scoreSample(s));
+  s.pressureCentiIn = 2960;
+  TEST_ASSERT_EQUAL_INT(ideal - 20, scoreSample(s));
+  s.pressureCentiIn = 2959;
+  TEST_ASSERT_EQUAL_INT(ideal - 15, scoreSample(s));
+}
+
+// "temp >= 50 || temp <= 85" holds for every temperature, so outside the
+// ideal band it is always 10 points and never 5
+static void test_temperature_fallback_always_matches() {
+  WeatherSample s = baseline();
+  int ideal = scoreSample(s);
+  const int16_t temps[] = { SAMPLE_NO_TEMP, -400, 0, 499, 599, 751, 851, 1200, 1500 };
+  for (int16_t t : temps) {
+    s.tempDeciF = t;
+    TEST_ASSERT_EQUAL_INT(ideal - 10, scoreSample(s));
+    TEST_ASSERT_EQUAL_INT(fishScore(s), scoreSample(s));
+  }
+}
+
+// scoreModelLoad() on one file holding `text`
+static bool loadText(const char *text, ScoreModel &m) {
+  fakeSdClear();
+  fakeSdPut("/test.cfg", text);
+  m = defaultScoreModel;
+  return scoreModelLoad("/test.cfg", m);
+}
+
+static void test_config_file() {
+  ScoreModel m;
+  TEST_ASSERT_TRUE(loadText("# warmer\ntemp 65 80 20 # ideal\ntemp -inf inf 10\n\n"
+                            "cloud default 0\r\n", m));
+  const FactorModel &temp = m.factors[FACTOR_TEMP];
+  TEST_ASSERT_EQUAL_UINT8(2, temp.bandCount);
+  TEST_ASSERT_EQUAL_FLOAT(65, temp.bands[0].lo);
+  TEST_ASSERT_EQUAL_FLOAT(80, temp.bands[0].hi);
+  TEST_ASSERT_EQUAL_UINT8(20, temp.bands[0].points);
+  TEST_ASSERT_TRUE(isinf(temp.bands[1].hi) && temp.bands[1].lo < 0);
+  TEST_ASSERT_EQUAL_UINT8(0, m.factors[FACTOR_CLOUD].otherwise);
+  // Factors not named keep their compiled-in bands
+  TEST_ASSERT_EQUAL_UINT8(defaultScoreModel.factors[FACTOR_WIND].bandCount,
+                          m.factors[FACTOR_WIND].bandCount);
+  TEST_ASSERT_TRUE(loadText("rain 0 30 100\n", m));
+  TEST_ASSERT_EQUAL_UINT8(SCORE_MAX, m.factors[FACTOR_RAIN].bands[0].points);
+}
+
+static void test_config_rejects() {
+  const char *bad[] = {
+    "temp 60 75\n",             // no points
+    "temp 60 75 20 5\n",        // trailing token
+    "temp 60x 75 20\n",         // not a number
+    "temp 60 75 2.5\n",         // points are whole
+    "temp 60 75 -5\n",          // negative points
+    "temp 60 75 101\n",         // over SCORE_MAX
+    "temp 80 60 20\n",          // lo > hi
+    "temp nan 60 20\n",
+    "cloud default -1\n",
+    "cloud default 5 6\n",
+    "cloud default\n",
+    "fog 0 10 5\n",
+    "temp 1 2 1\ntemp 3 4 1\ntemp 5 6 1\ntemp 7 8 1\ntemp 9 10 1\n", // over SCORE_MAX_BANDS
+    // 64 characters, otherwise fine
+    "temp 60 75 20                                                   \n",
+  };
+  for (const char *text : bad) {
+    ScoreModel m;
+    TEST_ASSERT_FALSE_MESSAGE(loadText(text, m), text);
+    // Left untouched
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&defaultScoreModel, &m, sizeof m, text);
+  }
+  // 63 characters is fine
+  ScoreModel m;
+  TEST_ASSERT_TRUE(loadText("temp 60 75 20                                                  \n", m));
+}
+
+static void test_timing() {
+  static WeatherSample samples[4096];
+  srand(2);
+  for (WeatherSample &s : samples) {
+    s = baseline();
+    s.cloud = rand() % 102 - 1;
+    s.rainChance = rand() % 102 - 1;
+    s.windDeciMph = rand() % 500;
+    s.pressureCentiIn = rand() % 800 + 2700;
+    s.tempDeciF = rand() % 1200;
+  }
+  const int rounds = 500;
+  volatile long sink = 0;
+  uint64_t t0 = fakeNanos();
+  for (int r = 0; r < rounds; ++r) {
+    for (const WeatherSample &s : samples) sink += fishScore(s);
+  }
+  uint64_t t1 = fakeNanos();
+  for (int r = 0; r < rounds; ++r) {
+    for (const WeatherSample &s : samples) sink += scoreSample(s);
+  }
+  uint64_t t2 = fakeNanos();
+  double n = (double)rounds * 4096;
+  char msg[96];
+  snprintf(msg, sizeof msg, "fishScore %.1f ns, tables %.1f ns per sample", (t1 - t0) / n,
+           (t2 - t1) / n);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_value_of_every_field);
+  RUN_TEST(test_random_samples);
+  RUN_TEST(test_pressure_edges_compare_float_to_double);
+  RUN_TEST(test_temperature_fallback_always_matches);
+  RUN_TEST(test_config_file);
+  RUN_TEST(test_config_rejects);
+  RUN_TEST(test_timing);
+  return UNITY_END();
+}
@@ -0,0 +1,157 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "scoremodel.h"
+#include "fakes.h"
+
+// scoreMatrix() at K = 8 profiles over the full N = 72 slots, checked
+// cell by cell against scoreWith() and timed against it
+
+#define PROFILES 8
+
+static ScoreTables tables[PROFILES];
+static const ScoreTables *tablePtrs[PROFILES];
+
+// The two built-in profiles and six variations on them, so no two tables
+// score alike
+static void buildProfiles() {
+  for (uint8_t p = 0; p < PROFILES; ++p) {
+    ScoreModel m = p & 1 ? bassScoreModel : defaultScoreModel;
+    uint8_t shift = p / 2;
+    for (FactorModel &f : m.factors) {
+      f.otherwise += shift;
+      for (uint8_t b = 0; b < f.bandCount; ++b) f.bands[b].points += shift * (b + 1);
+    }
+    m.factors[FACTOR_TEMP].bands[0].lo += shift * 2;
+    m.factors[FACTOR_WIND].bands[0].hi -= shift;
+    scoreBuildTables(m, tables[p]);
+    tablePtrs[p] = &tables[p];
+  }
+}
+
+// A forecast with `hours` slots of varied readings, the rest left at the
+// missing-value sentinels
+static void makeForecast(HourlyForecast &f, uint8_t hours, unsigned seed) {
+  srand(seed);
+  forecastClear(f);
+  f.startEpoch = 1718773200;
+  f.hours = hours;
+  for (uint8_t i = 0; i < hours; ++i) {
+    f.tempDeciF[i] = rand() % 1300 - 50;
+    f.pressureCentiIn[i] = rand() % 700 + 2650;
+    f.windDeciMph[i] = rand() % 400;
+    f.cloud[i] = rand() % 102 - 1;
+    f.rainChance[i] = rand() % 102 - 1;
+    f.solunar[i] = rand() % 102 - 1;
+  }
+}
+
+static WeatherSample slotSample(const HourlyForecast &f, int i) {
+  WeatherSample s;
+  sampleClear(s);
+  s.tempDeciF = f.tempDeciF[i];
+  s.pressureCentiIn = f.pressureCentiIn[i];
+  s.windDeciMph = f.windDeciMph[i];
+  s.cloud = f.cloud[i];
+  s.rainChance = f.rainChance[i];
+  return s;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_matches_score_with() {
+  static HourlyForecast f;
+  static ScoreIndices idx;
+  static uint8_t scores[PROFILES][FORECAST_HOURS];
+  const uint8_t hours[] = { FORECAST_HOURS, 48, 1, 0 };
+  for (uint8_t h : hours) {
+    makeForecast(f, h, h + 1);
+    scoreIndices(f, idx);
+    for (uint8_t k = 1; k <= PROFILES; ++k) {
+      memset(scores, 0xEE, sizeof scores);
+      scoreMatrix(idx, tablePtrs, k, scores);
+      for (uint8_t p = 0; p < PROFILES; ++p) {
+        for (int i = 0; i < FORECAST_HOURS; ++i) {
+          // Rows past k are left alone
+          int want = p < k ? scoreWith(tables[p], slotSample(f, i), f.solunar[i]) : 0xEE;
+          if (scores[p][i] == want) continue;
+          char msg[48];
+          snprintf(msg, sizeof msg, "hours %u k %u profile %u slot %d", h, k, p, i);
+          TEST_ASSERT_EQUAL_INT_MESSAGE(want, scores[p][i], msg);
+        }
+      }
+    }
+  }
+}
+
+// Every weather band and fallback at 60 points and no solunar bonus: the
+// five factors sum to 300, past what a uint8_t holds, and every cell must
+// come out capped rather than wrapped to 44
+static void test_high_points_cap() {
+  static HourlyForecast f;
+  static ScoreIndices idx;
+  static uint8_t scores[1][FORECAST_HOURS];
+  ScoreModel m = defaultScoreModel;
+  for (uint8_t i = 0; i < FACTOR_COUNT; ++i) {
+    FactorModel &factor = m.factors[i];
+    uint8_t points = i == FACTOR_SOLUNAR ? 0 : 60;
+    factor.otherwise = points;
+    for (uint8_t b = 0; b < factor.bandCount; ++b) factor.bands[b].points = points;
+  }
+  static ScoreTables high;
+  scoreBuildTables(m, high);
+  const ScoreTables *ptr = &high;
+  makeForecast(f, FORECAST_HOURS, 7);
+  scoreIndices(f, idx);
+  scoreMatrix(idx, &ptr, 1, scores);
+  for (int i = 0; i < FORECAST_HOURS; ++i) {
+    TEST_ASSERT_EQUAL_INT(SCORE_MAX, scoreWith(high, slotSample(f, i), f.solunar[i]));
+    TEST_ASSERT_EQUAL_INT(SCORE_MAX, scores[0][i]);
+  }
+}
+
+// Per forecast: the index pass plus K x N cells, against scoreWith() on
+// each cell
+static void test_benchmark() {
+  const int rounds = 20000;
+  static HourlyForecast f;
+  static ScoreIndices idx;
+  static uint8_t scores[PROFILES][FORECAST_HOURS];
+  static WeatherSample samples[FORECAST_HOURS];
+  makeForecast(f, FORECAST_HOURS, 99);
+  for (int i = 0; i < FORECAST_HOURS; ++i) samples[i] = slotSample(f, i);
+  volatile uint32_t sink = 0;
+
+  uint64_t t0 = fakeNanos();
+  for (int r = 0; r < rounds; ++r) {
+    for (uint8_t p = 0; p < PROFILES; ++p) {
+      for (int i = 0; i < FORECAST_HOURS; ++i) {
+        scores[p][i] = scoreWith(*tablePtrs[p], samples[i], f.solunar[i]);
+      }
+    }
+    sink += scores[r % PROFILES][r % FORECAST_HOURS];
+  }
+  uint64_t t1 = fakeNanos();
+  for (int r = 0; r < rounds; ++r) {
+    scoreIndices(f, idx);
+    scoreMatrix(idx, tablePtrs, PROFILES, scores);
+    sink += scores[r % PROFILES][r % FORECAST_HOURS];
+  }
+  uint64_t t2 = fakeNanos();
+
+  double cells = (double)rounds * PROFILES * FORECAST_HOURS;
+  char msg[128];
+  snprintf(msg, sizeof msg, "K=%d N=%d: scoreWith %.2f ns/cell, scoreMatrix %.2f ns/cell",
+           PROFILES, FORECAST_HOURS, (t1 - t0) / cells, (t2 - t1) / cells);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  buildProfiles();
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_score_with);
+  RUN_TEST(test_high_points_cap);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "solunar.h"
+#include "fakes.h"
+
+// Moon times for Lincoln, NE, against a full ELP-2000/82 reference (Meeus,
+// Astronomical Algorithms ch. 47, topocentric, upper limb at -34'), which
+// reproduces USNO's published phase instants to within a minute. Rise and
+// set must land within a few minutes of it.
+
+static const GeoPoint lincoln = { 40.8136f, -96.7026f };
+
+#define RISE_SET_TOLERANCE_MIN 3
+
+struct MoonRow {
+  uint32_t midnightEpoch; // local midnight, CST or CDT
+  uint16_t moonrise;      // minutes after it
+  uint16_t moonset;
+};
+
+static const MoonRow rows[] = {
+  { 1704952800, 507, 1049 },  // 2024-01-11, new moon
+  { 1706162400, 1051, 487 },  // 2024-01-25, full
+  { 1712552400, 415, 1216 },  // 2024-04-08, new (eclipse)
+  { 1718773200, 1152, 220 },  // 2024-06-19
+  { 1726549200, 1171, 385 },  // 2024-09-17
+  { 1733032800, 495, 1020 },  // 2024-12-01
+  { 1736748000, 1023, 482 },  // 2025-01-13, full
+  { 1738130400, 487, 1078 },  // 2025-01-29, new
+  { 1741928400, 1212, 470 },  // 2025-03-14, full (eclipse)
+};
+
+static SolunarDay computeAt(uint32_t epoch) {
+  LocalDay day;
+  TEST_ASSERT_TRUE(localDayOf(epoch, day));
+  SolunarDay out;
+  solunarCompute(lincoln, day, out);
+  return out;
+}
+
+void setUp() {
+  setenv("TZ", "CST6CDT,M3.2.0,M11.1.0", 1);
+  tzset();
+}
+
+void tearDown() {}
+
+static void test_rise_and_set() {
+  for (const MoonRow &r : rows) {
+    SolunarDay d = computeAt(r.midnightEpoch + 12 * 3600);
+    char msg[48];
+    snprintf(msg, sizeof msg, "day of %lu", (unsigned long)r.midnightEpoch);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(RISE_SET_TOLERANCE_MIN, r.moonrise, d.moonrise, msg);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(RISE_SET_TOLERANCE_MIN, r.moonset, d.moonset, msg);
+  }
+}
+
+static void test_june_19_2024() {
+  SolunarDay d = computeAt(1718773200 + 12 * 3600);
+  TEST_ASSERT_INT_WITHIN(1, 94, d.illumination);
+  TEST_ASSERT_EQUAL_UINT8(MOON_WAXING_GIBBOUS, d.phase);
+  TEST_ASSERT_EQUAL_STRING("Wax Gibb", moonPhaseText(d.phase));
+  // 19:12 CDT
+  TEST_ASSERT_INT_WITHIN(RISE_SET_TOLERANCE_MIN, 19 * 60 + 12, d.moonrise);
+}
+
+// USNO's phase instants (UT). Phase values are taken at local noon, so a
+// day is laid out with its noon on the instant itself.
+struct PhaseRow {
+  uint32_t epoch;
+  bool full;
+};
+
+static const PhaseRow phases[] = {
+  { 1704974220, false }, // 2024-01-11 11:57
+  { 1706205240, true },  // 2024-01-25 17:54
+  { 1712600460, false }, // 2024-04-08 18:21
+  { 1713916140, true },  // 2024-04-23 23:49
+  { 1736807220, true },  // 2025-01-13 22:27
+  { 1738154160, false }, // 2025-01-29 12:36
+};
+
+static void test_phase_instants() {
+  for (const PhaseRow &p : phases) {
+    LocalDay day = { 0, p.epoch - 12 * 3600 };
+    SolunarDay d;
+    solunarCompute(lincoln, day, d);
+    char msg[32];
+    snprintf(msg, sizeof msg, "phase at %lu", (unsigned long)p.epoch);
+    if (p.full) {
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(MOON_FULL, d.phase, msg);
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(100, d.illumination, msg);
+      // Half a synodic month, 14.77 days
+      TEST_ASSERT_INT_WITHIN_MESSAGE(1, 148, d.ageTenths, msg);
+    } else {
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(MOON_NEW, d.phase, msg);
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(0, d.illumination, msg);
+      // Either side of the wrap at 29.53 days
+      TEST_ASSERT_TRUE_MESSAGE(d.ageTenths <= 1 || d.ageTenths >= 294, msg);
+    }
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_rise_and_set);
+  RUN_TEST(test_june_19_2024);
+  RUN_TEST(test_phase_instants);
+  return UNITY_END();
+}
@@ -0,0 +1,84 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "suncalc.h"
+#include "fakes.h"
+
+// Sun times for Lincoln, NE against the sun's altitude from Meeus'
+// series (-0.833 degrees for rise and set, -6 for civil twilight), and
+// the polar cases that have no event at all
+
+#define SUN_TOLERANCE_MIN 2
+
+struct SunRow {
+  uint32_t midnightEpoch;
+  uint16_t dawn;
+  uint16_t sunrise;
+  uint16_t sunset;
+  uint16_t dusk;
+};
+
+static const SunRow lincolnRows[] = {
+  { 1718773200, 322, 355, 1262, 1295 }, // 2024-06-19, 05:55 and 21:02 CDT
+  { 1734760800, 437, 468, 1023, 1054 }, // 2024-12-21
+  { 1710910800, 422, 449, 1180, 1207 }, // 2024-03-20
+  // 2024-11-03, back to CST at 02:00. The day is taken at noon's offset,
+  // so minutes are wall-clock CST: 06:32, not 452 elapsed since midnight CDT
+  { 1730610000, 392, 420, 1040, 1069 },
+};
+
+static SunDay computeAt(const GeoPoint &p, const char *tz, uint32_t epoch) {
+  setenv("TZ", tz, 1);
+  tzset();
+  LocalDay day;
+  TEST_ASSERT_TRUE(localDayOf(epoch, day));
+  SunDay out;
+  sunCompute(p, day, out);
+  return out;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_lincoln() {
+  const GeoPoint lincoln = { 40.8136f, -96.7026f };
+  for (const SunRow &r : lincolnRows) {
+    SunDay d = computeAt(lincoln, "CST6CDT,M3.2.0,M11.1.0", r.midnightEpoch + 12 * 3600);
+    char msg[32];
+    snprintf(msg, sizeof msg, "day of %lu", (unsigned long)r.midnightEpoch);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(SUN_TOLERANCE_MIN, r.dawn, d.dawn, msg);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(SUN_TOLERANCE_MIN, r.sunrise, d.sunrise, msg);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(SUN_TOLERANCE_MIN, r.sunset, d.sunset, msg);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(SUN_TOLERANCE_MIN, r.dusk, d.dusk, msg);
+  }
+}
+
+// Longyearbyen, 78 N: no sunrise in December, not even civil twilight,
+// and no sunset in June
+static void test_polar_night_and_day() {
+  const GeoPoint svalbard = { 78.2232f, 15.6267f };
+  const char *tz = "CET-1CEST,M3.5.0,M10.5.0/3";
+  SunDay night = computeAt(svalbard, tz, 1734778800); // 2024-12-21 12:00 CET
+  TEST_ASSERT_EQUAL_UINT16(SAMPLE_NO_TIME, night.dawn);
+  TEST_ASSERT_EQUAL_UINT16(SAMPLE_NO_TIME, night.sunrise);
+  TEST_ASSERT_EQUAL_UINT16(SAMPLE_NO_TIME, night.sunset);
+  TEST_ASSERT_EQUAL_UINT16(SAMPLE_NO_TIME, night.dusk);
+
+  SunDay day = computeAt(svalbard, tz, 1718791200); // 2024-06-19 12:00 CEST
+  TEST_ASSERT_EQUAL_UINT16(SAMPLE_NO_TIME, day.sunrise);
+  TEST_ASSERT_EQUAL_UINT16(SAMPLE_NO_TIME, day.sunset);
+}
+
+static void test_no_clock() {
+  SunDay sun = {};
+  const GeoPoint lincoln = { 40.8136f, -96.7026f };
+  TEST_ASSERT_NULL(sunToday(sun, lincoln, 1000));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_lincoln);
+  RUN_TEST(test_polar_night_and_day);
+  RUN_TEST(test_no_clock);
+  return UNITY_END();
+}
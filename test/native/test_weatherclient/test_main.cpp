@@ -0,0 +1,235 @@
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <SD.h>
+#include <unity.h>
+#include "gzipstream.h"
+#include "log.h"
+#include "weatherclient.h"
+#include "fakes.h"
+
+// WeatherClient against gzip-encoded copies of the response fixtures, sent
+// with Content-Length and chunked: what it reads must equal the plain body
+// parsed directly, and a cut-short or corrupted body must fail. Also checks
+// what goes out in Accept-Encoding, and that a request finding the shared
+// inflater taken asks for identity.
+
+static std::string contentLength(const std::string &body) {
+  return "Content-Length: " + std::to_string(body.size()) + "\r\n";
+}
+
+static void parsePlain(const char *name, WeatherSample &out, HourlyForecast &hourly) {
+  std::string path = std::string("/") + name;
+  fakeSdPut(path.c_str(), fixtureRead(name));
+  fs::File in = SD.open(path.c_str());
+  TEST_ASSERT_TRUE(parseWeather(in, out, &hourly));
+}
+
+// Field by field: HourlyForecast has padding that copies need not keep
+static void assertSameResult(const WeatherSample &want, const HourlyForecast &wantHourly,
+                             const WeatherSample &got, const HourlyForecast &gotHourly) {
+  TEST_ASSERT_EQUAL_MEMORY(&want, &got, sizeof want);
+  TEST_ASSERT_EQUAL_UINT32(wantHourly.startEpoch, gotHourly.startEpoch);
+  TEST_ASSERT_EQUAL_UINT8(wantHourly.hours, gotHourly.hours);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(wantHourly.tempDeciF, gotHourly.tempDeciF, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(wantHourly.pressureCentiIn, gotHourly.pressureCentiIn,
+                                FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(wantHourly.windDeciMph, gotHourly.windDeciMph, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT8_ARRAY(wantHourly.cloud, gotHourly.cloud, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT8_ARRAY(wantHourly.rainChance, gotHourly.rainChance, FORECAST_HOURS);
+}
+
+static bool hasHeader(const FakeHttpRequest &req, const char *line) {
+  return req.headers.find(std::string(line) + "\r\n") != std::string::npos;
+}
+
+static bool logged(const char *prefix) {
+  for (uint32_t i = 0; i < fakeLogLines(); ++i) {
+    if (fakeLogLine(i).compare(0, strlen(prefix), prefix) == 0) return true;
+  }
+  return false;
+}
+
+static WeatherSample want;
+static HourlyForecast wantHourly;
+static WeatherSample got;
+static HourlyForecast gotHourly;
+
+void setUp() {
+  fakeHttpReset();
+  fakeLogReset();
+}
+
+void tearDown() {}
+
+static void fetchForecast(const std::string &headers, const std::string &body, bool gzipped) {
+  fakeHttpRoute("forecast.json", 200, headers, body);
+  WeatherClient client("api.weatherapi.com", 80, "key");
+  TEST_ASSERT_EQUAL_INT(200, client.fetch("Lincoln,NE", got, &gotHourly));
+  TEST_ASSERT_EQUAL(gzipped, client.lastGzipped());
+  assertSameResult(want, wantHourly, got, gotHourly);
+}
+
+static void test_gzip_with_content_length() {
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  fetchForecast("Content-Encoding: gzip\r\n" + contentLength(gz), gz, true);
+}
+
+static void test_gzip_chunked() {
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  for (size_t chunk : { 1, 7, 256, 1460 }) {
+    fetchForecast("Content-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n",
+                  fakeHttpChunked(gz, chunk), true);
+  }
+}
+
+// A gzip body that fails must fail the fetch rather than pass what was
+// parsed from it. The end of the body is known from its framing, so this
+// takes no timeout.
+static void fetchBadGzip(const std::string &headers, const std::string &body) {
+  fakeHttpRoute("forecast.json", 200, headers, body);
+  WeatherClient client("api.weatherapi.com", 80, "key");
+  uint32_t start = millis();
+  TEST_ASSERT_EQUAL_INT(WEATHER_PARSE_FAILED, client.fetch("Lincoln,NE", got, &gotHourly));
+  TEST_ASSERT_TRUE(client.lastGzipped());
+  TEST_ASSERT_TRUE(millis() - start < WEATHER_BODY_TIMEOUT_MS);
+}
+
+// The JSON all inflates, but the body ends before or inside the trailer.
+// A cut inside the JSON is left to the parser, which waits out its timeout.
+static void test_gzip_truncated() {
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  for (size_t cut : { gz.size() - 8, gz.size() - 3 }) {
+    std::string part = gz.substr(0, cut);
+    fetchBadGzip("Content-Encoding: gzip\r\n" + contentLength(part), part);
+    fetchBadGzip("Content-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n",
+                 fakeHttpChunked(part, 256));
+  }
+}
+
+// The inflated data is intact; only the trailer says otherwise
+static void test_gzip_bad_trailer() {
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  std::string badCrc = gz;
+  badCrc[badCrc.size() - 8] ^= 0x01;
+  fetchBadGzip("Content-Encoding: gzip\r\n" + contentLength(badCrc), badCrc);
+  std::string badSize = gz;
+  badSize[badSize.size() - 4] ^= 0x01;
+  fetchBadGzip("Content-Encoding: gzip\r\n" + contentLength(badSize), badSize);
+}
+
+// A server may still answer a gzip request with identity
+static void test_identity_reply_to_gzip_request() {
+  std::string plain = fixtureRead("forecast_lincoln.json");
+  fetchForecast(contentLength(plain), plain, false);
+}
+
+static size_t countOf(const std::string &text, const std::string &needle) {
+  size_t n = 0;
+  for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) n++;
+  return n;
+}
+
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+// The preference replaces the core's own header rather than tying with it
+static void test_request_carries_one_accept_encoding() {
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  fetchForecast("Content-Encoding: gzip\r\n" + contentLength(gz), gz, true);
+  std::vector<FakeHttpRequest> sent = fakeHttpRequests();
+  TEST_ASSERT_EQUAL_UINT32(1, sent.size());
+  TEST_ASSERT_EQUAL_UINT32(1, countOf(sent[0].headers, "Accept-Encoding:"));
+  TEST_ASSERT_TRUE(hasHeader(sent[0], "Accept-Encoding: gzip;q=1, identity;q=0.5"));
+}
+#else
+// Older cores send their own line first; ours follows it
+static void test_request_carries_both_accept_encodings() {
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  fetchForecast("Content-Encoding: gzip\r\n" + contentLength(gz), gz, true);
+  std::vector<FakeHttpRequest> sent = fakeHttpRequests();
+  TEST_ASSERT_EQUAL_UINT32(1, sent.size());
+  const std::string &h = sent[0].headers;
+  size_t core = h.find("Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n");
+  size_t ours = h.find("Accept-Encoding: gzip;q=1, identity;q=0.5\r\n");
+  TEST_ASSERT_TRUE(core != std::string::npos);
+  TEST_ASSERT_TRUE(ours != std::string::npos);
+  TEST_ASSERT_TRUE(core < ours);
+}
+#endif
+
+static void test_busy_inflater_asks_for_identity() {
+  std::string plain = fixtureRead("forecast_lincoln.json");
+  std::string gz = fixtureRead("forecast_lincoln.json.gz");
+  // One client throughout: what it asked for last time must not stick
+  WeatherClient client("api.weatherapi.com", 80, "key");
+  fakeHttpRoute("forecast.json", 200, "Content-Encoding: gzip\r\n" + contentLength(gz), gz);
+  TEST_ASSERT_EQUAL_INT(200, client.fetch("Lincoln,NE", got, &gotHourly));
+  TEST_ASSERT_TRUE(client.lastGzipped());
+
+  bool busy;
+  TEST_ASSERT_NOT_NULL(gzipClaim(busy));
+  GzipStream *second = gzipClaim(busy);
+  TEST_ASSERT_NULL(second);
+  TEST_ASSERT_TRUE(busy);
+
+  fakeHttpReset();
+  fakeHttpRoute("forecast.json", 200, contentLength(plain), plain);
+  TEST_ASSERT_EQUAL_INT(200, client.fetch("Lincoln,NE", got, &gotHourly));
+  TEST_ASSERT_FALSE(client.lastGzipped());
+  assertSameResult(want, wantHourly, got, gotHourly);
+  const FakeHttpRequest identity = fakeHttpRequests()[0];
+  TEST_ASSERT_EQUAL_UINT32(0, countOf(identity.headers, "gzip"));
+  TEST_ASSERT_TRUE(hasHeader(identity, "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0"));
+  TEST_ASSERT_TRUE(logged("gzip skipped"));
+
+  // Once it is free again the next request takes it
+  gzipRelease();
+  fakeHttpReset();
+  fakeLogReset();
+  fakeHttpRoute("forecast.json", 200, "Content-Encoding: gzip\r\n" + contentLength(gz), gz);
+  TEST_ASSERT_EQUAL_INT(200, client.fetch("Lincoln,NE", got, &gotHourly));
+  TEST_ASSERT_TRUE(client.lastGzipped());
+  TEST_ASSERT_TRUE(hasHeader(fakeHttpRequests()[0], "Accept-Encoding: gzip;q=1, identity;q=0.5"));
+  TEST_ASSERT_FALSE(logged("gzip skipped"));
+  TEST_ASSERT_NOT_NULL(gzipClaim(busy));
+  gzipRelease();
+}
+
+static void test_bulk_gzip_matches_plain() {
+  std::string plain = fixtureRead("bulk_forecast.json");
+  fakeSdPut("/bulk.json", plain);
+  fs::File in = SD.open("/bulk.json");
+  WeatherSample plainOut[2];
+  static HourlyForecast plainHourly[2];
+  WeatherSample error;
+  uint32_t found;
+  TEST_ASSERT_EQUAL_INT(2, parseWeatherBulk(in, plainOut, plainHourly, 2, found, error));
+
+  std::string gz = fixtureRead("bulk_forecast.json.gz");
+  fakeHttpRoute("q=bulk", 200, "Content-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n",
+                fakeHttpChunked(gz, 512));
+  WeatherClient client("api.weatherapi.com", 80, "key");
+  String locations[2] = { "Lincoln,NE", "Omaha,NE" };
+  WeatherSample out[2];
+  static HourlyForecast hourly[2];
+  TEST_ASSERT_EQUAL_UINT32(0x3, client.fetchBulk(locations, 2, 0x3, out, hourly));
+  TEST_ASSERT_TRUE(client.lastGzipped());
+  for (int i = 0; i < 2; ++i) assertSameResult(plainOut[i], plainHourly[i], out[i], hourly[i]);
+}
+
+int main() {
+  logBegin(115200);
+  parsePlain("forecast_lincoln.json", want, wantHourly);
+  UNITY_BEGIN();
+  RUN_TEST(test_gzip_with_content_length);
+  RUN_TEST(test_gzip_chunked);
+  RUN_TEST(test_gzip_truncated);
+  RUN_TEST(test_gzip_bad_trailer);
+  RUN_TEST(test_identity_reply_to_gzip_request);
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  RUN_TEST(test_request_carries_one_accept_encoding);
+#else
+  RUN_TEST(test_request_carries_both_accept_encodings);
+#endif
+  RUN_TEST(test_busy_inflater_asks_for_identity);
+  RUN_TEST(test_bulk_gzip_matches_plain);
+  return UNITY_END();
+}
@@ -0,0 +1,228 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <SD.h>
+#include <unity.h>
+#include "weatherparse.h"
+#include "fakes.h"
+
+// The single-pass scanner against the ArduinoJson filter path it replaced,
+// on full WeatherAPI response bodies: both must quantize to the same
+// sample and hourly forecast, and the benchmark times the two side by side.
+
+// The old filter, widened to every field parseWeather() now extracts. A
+// filter's first array element applies to all elements.
+static void buildFilter(JsonDocument &filter) {
+  for (const char *key : { "last_updated_epoch", "temp_f", "wind_mph", "wind_dir", "pressure_in",
+                           "cloud" }) {
+    filter["current"][key] = true;
+  }
+  filter["forecast"]["forecastday"][0]["day"]["daily_chance_of_rain"] = true;
+  for (const char *key : { "time_epoch", "temp_f", "wind_mph", "pressure_in", "cloud",
+                           "chance_of_rain" }) {
+    filter["forecast"]["forecastday"][0]["hour"][0][key] = true;
+  }
+  filter["error"]["code"] = true;
+  filter["error"]["message"] = true;
+}
+
+static int16_t quantize(JsonVariantConst v, int16_t missing, double scale) {
+  if (v.isNull()) return missing;
+  return (int16_t)constrain(lround(v.as<double>() * scale), -32768L, 32767L);
+}
+
+static int8_t percent(JsonVariantConst v) {
+  if (v.isNull()) return SAMPLE_NO_PERCENT;
+  return (int8_t)constrain(v.as<long>(), -1L, 100L);
+}
+
+// Same quantization as weatherparse.cpp, from the filtered document
+static void extract(const JsonDocument &doc, WeatherSample &out, HourlyForecast *hourly) {
+  sampleClear(out);
+  JsonObjectConst current = doc["current"];
+  if (!current.isNull()) {
+    out.updatedEpoch = current["last_updated_epoch"] | 0UL;
+    out.tempDeciF = quantize(current["temp_f"], SAMPLE_NO_TEMP, 10);
+    out.windDeciMph = quantize(current["wind_mph"], SAMPLE_NO_WIND, 10);
+    if (current.containsKey("wind_dir")) {
+      out.windDir = windDirFromText(current["wind_dir"].as<const char *>());
+    }
+    out.pressureCentiIn = quantize(current["pressure_in"], SAMPLE_NO_PRESSURE, 100);
+    out.cloud = percent(current["cloud"]);
+  }
+  JsonArrayConst days = doc["forecast"]["forecastday"];
+  if (!days.isNull()) out.rainChance = percent(days[0]["day"]["daily_chance_of_rain"]);
+  JsonObjectConst error = doc["error"];
+  if (!error.isNull()) {
+    out.apiError = error["code"] | 0;
+    if (error.containsKey("message") && !out.apiError) out.apiError = SAMPLE_ERROR_UNKNOWN;
+  }
+
+  if (!hourly) return;
+  forecastClear(*hourly);
+  int d = 0;
+  for (JsonObjectConst day : days) {
+    int h = 0;
+    for (JsonObjectConst item : day["hour"].as<JsonArrayConst>()) {
+      int slot = d * 24 + h++;
+      if (slot >= FORECAST_HOURS) break;
+      if (slot == 0) hourly->startEpoch = item["time_epoch"] | 0UL;
+      hourly->tempDeciF[slot] = quantize(item["temp_f"], SAMPLE_NO_TEMP, 10);
+      hourly->windDeciMph[slot] = quantize(item["wind_mph"], SAMPLE_NO_WIND, 10);
+      hourly->pressureCentiIn[slot] = quantize(item["pressure_in"], SAMPLE_NO_PRESSURE, 100);
+      hourly->cloud[slot] = percent(item["cloud"]);
+      hourly->rainChance[slot] = percent(item["chance_of_rain"]);
+      hourly->hours = slot + 1;
+    }
+    d++;
+  }
+}
+
+static StaticJsonDocument<1024> filter;
+// Three days of hours with six members each, on a 64-bit host
+static DynamicJsonDocument doc(32768);
+
+static bool parseArduinoJson(Stream &in, WeatherSample &out, HourlyForecast *hourly) {
+  DeserializationError error = deserializeJson(doc, in, DeserializationOption::Filter(filter));
+  if (error) return false;
+  extract(doc, out, hourly);
+  return true;
+}
+
+static fs::File openFixture(const char *name) {
+  std::string path = std::string("/") + name;
+  if (!SD.exists(path.c_str())) {
+    std::string body = fixtureRead(name);
+    TEST_ASSERT_FALSE_MESSAGE(body.empty(), name);
+    fakeSdPut(path.c_str(), body);
+  }
+  return SD.open(path.c_str());
+}
+
+static void assertSameSample(const WeatherSample &want, const WeatherSample &got) {
+  TEST_ASSERT_EQUAL_UINT32(want.updatedEpoch, got.updatedEpoch);
+  TEST_ASSERT_EQUAL_INT16(want.tempDeciF, got.tempDeciF);
+  TEST_ASSERT_EQUAL_INT16(want.pressureCentiIn, got.pressureCentiIn);
+  TEST_ASSERT_EQUAL_INT16(want.windDeciMph, got.windDeciMph);
+  TEST_ASSERT_EQUAL_INT8(want.cloud, got.cloud);
+  TEST_ASSERT_EQUAL_INT8(want.rainChance, got.rainChance);
+  TEST_ASSERT_EQUAL_UINT16(want.apiError, got.apiError);
+  TEST_ASSERT_EQUAL_UINT8(want.windDir, got.windDir);
+  TEST_ASSERT_EQUAL_MEMORY(&want, &got, sizeof want);
+}
+
+static void assertSameForecast(const HourlyForecast &want, const HourlyForecast &got) {
+  TEST_ASSERT_EQUAL_UINT32(want.startEpoch, got.startEpoch);
+  TEST_ASSERT_EQUAL_UINT8(want.hours, got.hours);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(want.tempDeciF, got.tempDeciF, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(want.pressureCentiIn, got.pressureCentiIn, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(want.windDeciMph, got.windDeciMph, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT8_ARRAY(want.cloud, got.cloud, FORECAST_HOURS);
+  TEST_ASSERT_EQUAL_INT8_ARRAY(want.rainChance, got.rainChance, FORECAST_HOURS);
+}
+
+// Parses one fixture both ways and checks they agree
+static void parseBoth(const char *name, WeatherSample &sample, HourlyForecast &hourly) {
+  WeatherSample reference;
+  static HourlyForecast referenceHourly;
+  fs::File a = openFixture(name);
+  TEST_ASSERT_TRUE_MESSAGE(parseArduinoJson(a, reference, &referenceHourly), name);
+  TEST_ASSERT_FALSE_MESSAGE(doc.overflowed(), name);
+  fs::File b = openFixture(name);
+  TEST_ASSERT_TRUE_MESSAGE(parseWeather(b, sample, &hourly), name);
+  assertSameSample(reference, sample);
+  assertSameForecast(referenceHourly, hourly);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_forecast_matches_arduinojson() {
+  WeatherSample s;
+  static HourlyForecast f;
+  parseBoth("forecast_lincoln.json", s, f);
+  // Spot checks against the fixture itself
+  TEST_ASSERT_EQUAL_UINT32(1718825400, s.updatedEpoch);
+  TEST_ASSERT_EQUAL_INT16(850, s.tempDeciF);
+  TEST_ASSERT_EQUAL_INT16(2983, s.pressureCentiIn);
+  TEST_ASSERT_EQUAL_UINT8(WIND_SSW, s.windDir);
+  TEST_ASSERT_EQUAL_UINT8(FORECAST_HOURS, f.hours);
+  // Local midnight, 2024-06-19 CDT
+  TEST_ASSERT_EQUAL_UINT32(1718773200, f.startEpoch);
+}
+
+static void test_current_matches_arduinojson() {
+  WeatherSample s;
+  static HourlyForecast f;
+  parseBoth("current_lincoln.json", s, f);
+  TEST_ASSERT_EQUAL_INT8(SAMPLE_NO_PERCENT, s.rainChance);
+  TEST_ASSERT_EQUAL_UINT8(0, f.hours);
+}
+
+static void test_error_matches_arduinojson() {
+  WeatherSample s;
+  static HourlyForecast f;
+  parseBoth("error_key.json", s, f);
+  TEST_ASSERT_EQUAL_UINT16(2006, s.apiError);
+  TEST_ASSERT_EQUAL_INT16(SAMPLE_NO_TEMP, s.tempDeciF);
+}
+
+// Each bulk element must read the same as that location's own response;
+// the fixture lists them out of custom_id order
+static void test_bulk_matches_single() {
+  WeatherSample single;
+  static HourlyForecast singleHourly;
+  parseBoth("forecast_lincoln.json", single, singleHourly);
+
+  WeatherSample out[2];
+  static HourlyForecast hourly[2];
+  WeatherSample error;
+  uint32_t found = 0;
+  fs::File in = openFixture("bulk_forecast.json");
+  TEST_ASSERT_EQUAL_INT(2, parseWeatherBulk(in, out, hourly, 2, found, error));
+  TEST_ASSERT_EQUAL_UINT32(0x3, found);
+  TEST_ASSERT_FALSE(sampleHasError(error));
+  assertSameSample(single, out[0]);
+  assertSameForecast(singleHourly, hourly[0]);
+  TEST_ASSERT_EQUAL_UINT8(FORECAST_HOURS, hourly[1].hours);
+}
+
+// Time per forecast response, read from the fake SD card so both see the
+// same byte-at-a-time Stream
+static void test_benchmark() {
+  const int rounds = 200;
+  WeatherSample s;
+  static HourlyForecast f;
+  fs::File probe = openFixture("forecast_lincoln.json");
+  size_t bytes = probe.size();
+
+  uint64_t t0 = fakeNanos();
+  for (int i = 0; i < rounds; ++i) {
+    fs::File in = openFixture("forecast_lincoln.json");
+    TEST_ASSERT_TRUE(parseArduinoJson(in, s, &f));
+  }
+  uint64_t t1 = fakeNanos();
+  for (int i = 0; i < rounds; ++i) {
+    fs::File in = openFixture("forecast_lincoln.json");
+    TEST_ASSERT_TRUE(parseWeather(in, s, &f));
+  }
+  uint64_t t2 = fakeNanos();
+
+  char msg[160];
+  snprintf(msg, sizeof msg,
+           "%u-byte forecast: ArduinoJson %.1f us (%u-byte document), jsonscan %.1f us (no heap)",
+           (unsigned)bytes, (t1 - t0) / 1000.0 / rounds, (unsigned)doc.memoryUsage(),
+           (t2 - t1) / 1000.0 / rounds);
+  TEST_MESSAGE(msg);
+}
+
+int main() {
+  buildFilter(filter);
+  UNITY_BEGIN();
+  RUN_TEST(test_forecast_matches_arduinojson);
+  RUN_TEST(test_current_matches_arduinojson);
+  RUN_TEST(test_error_matches_arduinojson);
+  RUN_TEST(test_bulk_matches_single);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""
+Asks WeatherAPI for the firmware's forecast request and reports how the body
+comes back. The ESP32 core sends its own
+  Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0
+on every HTTP/1.1 request. From core 3.0 the firmware replaces it with
+"gzip;q=1, identity;q=0.5"; before that it can only add that as a second
+line. Whether gzip is used is up to the server; this sends each of those,
+and the core's alone, and prints Content-Encoding and the body size for
+each.
+
+Usage:
+  python3 tools/check_gzip.py KEY [--host api.weatherapi.com] [--q Lincoln,NE]
+"""
+
+import argparse
+import http.client
+from urllib.parse import quote
+
+CORE_ACCEPT = "identity;q=1,chunked;q=0.1,*;q=0"
+
+FIRMWARE_ACCEPT = "gzip;q=1, identity;q=0.5"
+
+VARIANTS = (
+    ("firmware", [FIRMWARE_ACCEPT]),
+    ("firmware, core < 3.0", [CORE_ACCEPT, FIRMWARE_ACCEPT]),
+    ("core only", [CORE_ACCEPT]),
+)
+
+
+def probe(host, path, accept):
+    conn = http.client.HTTPConnection(host, 80, timeout=15)
+    conn.putrequest("GET", path, skip_accept_encoding=True)
+    conn.putheader("User-Agent", "ESP32HTTPClient")
+    conn.putheader("Connection", "keep-alive")
+    for value in accept:
+        conn.putheader("Accept-Encoding", value)
+    conn.endheaders()
+    resp = conn.getresponse()
+    body = resp.read()
+    conn.close()
+    return resp.status, resp.getheader("Content-Encoding", "identity"), \
+        resp.getheader("Transfer-Encoding", "-"), len(body)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("key")
+    ap.add_argument("--host", default="api.weatherapi.com")
+    ap.add_argument("--q", default="Lincoln,NE")
+    args = ap.parse_args()
+
+    path = "/v1/forecast.json?key=%s&q=%s&days=3&aqi=no&alerts=no" % (args.key, quote(args.q))
+    for name, accept in VARIANTS:
+        status, encoding, transfer, size = probe(args.host, path, accept)
+        print("%-24s %d  Content-Encoding: %-8s Transfer-Encoding: %-8s %6d bytes"
+              % (name, status, encoding, transfer, size))
+
+
+if __name__ == "__main__":
+    main()
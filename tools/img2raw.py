@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+Convert BMP/PNG images into the native .565 asset read by drawRaw() and
+loadAtlas().
+
+Layout: 12-byte header (magic "R565", uint16 width, uint16 height,
+uint8 format, uint8 flags, uint16 spriteCount; little-endian), then
+spriteCount index entries (char name[12], uint16 x, y, w, h), then
+big-endian RGB565 pixels, top-down, no row padding.
+
+Transparency is a color key: setColorKey() on the device skips pixels of
+that color. Pixels an alpha channel marks as clear (alpha < 128, i.e. a
+1-bit mask) are written as the key, and so is the backdrop when
+--background is given: the run of the top-left pixel's color that
+touches the image edge. Opaque pixels that happen to be the key color
+are nudged one green step so they stay visible. --key picks the key;
+the default is magenta, FISH_COLOR_KEY in main.cpp.
+
+Usage:
+  python3 tools/img2raw.py --background fish.bmp fish.565
+  python3 tools/img2raw.py --atlas icons.565 sun=sun.png rain=rain.png ...
+Needs Pillow (pip install pillow).
+"""
+
+import struct
+import sys
+
+from PIL import Image
+
+RAW_MAGIC = b"R565"
+RAW_FORMAT_RGB565_BE = 0
+SPRITE_NAME_LEN = 12
+# Atlas sheets are packed in shelves no wider than the panel
+ATLAS_MAX_WIDTH = 320
+# TFT_MAGENTA
+DEFAULT_KEY = 0xF81F
+# Lowest green bit: the smallest change that moves a pixel off the key
+KEY_NUDGE = 0x0020
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def backdrop(pixels, w, h):
+    """Indexes of the top-left pixel's color reachable from the image edge."""
+    color = pixels[0][:3]
+    edge = [x for x in range(w)] + [(h - 1) * w + x for x in range(w)] + \
+           [y * w for y in range(h)] + [y * w + w - 1 for y in range(h)]
+    seen = set()
+    stack = [i for i in edge if pixels[i][:3] == color]
+    while stack:
+        i = stack.pop()
+        if i in seen:
+            continue
+        seen.add(i)
+        x, y = i % w, i // w
+        for nx, ny in ((x - 1, y), (x + 1, y), (x, y - 1), (x, y + 1)):
+            j = ny * w + nx
+            if 0 <= nx < w and 0 <= ny < h and j not in seen and pixels[j][:3] == color:
+                stack.append(j)
+    return seen
+
+
+def to_rgb565(img, key=DEFAULT_KEY, background=False):
+    """Pixel bytes, plus the counts of keyed and nudged pixels."""
+    w, h = img.size
+    pixels = list(img.convert("RGBA").getdata())
+    clear = backdrop(pixels, w, h) if background and pixels else set()
+    out = bytearray()
+    keyed = nudged = 0
+    for i, (r, g, b, a) in enumerate(pixels):
+        if a < 128 or i in clear:
+            value = key
+            keyed += 1
+        else:
+            value = rgb565(r, g, b)
+            if value == key:
+                value ^= KEY_NUDGE
+                nudged += 1
+        out += struct.pack(">H", value)
+    return bytes(out), keyed, nudged
+
+
+def write_asset(path, img, sprites=(), key=DEFAULT_KEY, background=False):
+    w, h = img.size
+    if w > 0xFFFF or h > 0xFFFF:
+        raise ValueError("image too large")
+    header = struct.pack("<4sHHBBH", RAW_MAGIC, w, h, RAW_FORMAT_RGB565_BE, 0, len(sprites))
+    index = b"".join(struct.pack("<12sHHHH", name.encode()[:SPRITE_NAME_LEN], x, y, sw, sh)
+                     for name, x, y, sw, sh in sprites)
+    pixels, keyed, nudged = to_rgb565(img, key, background)
+    with open(path, "wb") as f:
+        f.write(header)
+        f.write(index)
+        f.write(pixels)
+    print("%s: %dx%d, %d sprites, %d bytes, %d transparent, %d moved off key 0x%04X" %
+          (path, w, h, len(sprites), len(header) + len(index) + len(pixels), keyed, nudged,
+           key))
+
+
+def pack_atlas(specs):
+    """Shelf-pack name=path images, tallest first; returns (sheet, entries)."""
+    images = []
+    for spec in specs:
+        name, _, path = spec.partition("=")
+        if not path or len(name.encode()) > SPRITE_NAME_LEN:
+            raise ValueError("bad sprite spec %r (want name=path, name <= 12 bytes)" % spec)
+        images.append((name, Image.open(path).convert("RGBA")))
+    images.sort(key=lambda item: -item[1].size[1])
+
+    entries = []
+    x = y = shelf = width = 0
+    for name, img in images:
+        w, h = img.size
+        if w > ATLAS_MAX_WIDTH:
+            raise ValueError("sprite %s wider than %d" % (name, ATLAS_MAX_WIDTH))
+        if x + w > ATLAS_MAX_WIDTH:
+            x, y, shelf = 0, y + shelf, 0
+        entries.append((name, x, y, w, h))
+        x += w
+        shelf = max(shelf, h)
+        width = max(width, x)
+
+    # Space between sprites is left clear
+    sheet = Image.new("RGBA", (width, y + shelf), (0, 0, 0, 0))
+    for (name, img), (_, ex, ey, _, _) in zip(images, entries):
+        sheet.paste(img, (ex, ey))
+    return sheet, entries
+
+
+def main(argv):
+    args = argv[1:]
+    key = DEFAULT_KEY
+    background = False
+    while args and args[0] in ("--key", "--background"):
+        if args[0] == "--background":
+            background = True
+            args = args[1:]
+        elif len(args) >= 2:
+            r, g, b = bytes.fromhex(args[1].lstrip("#"))
+            key = rgb565(r, g, b)
+            args = args[2:]
+        else:
+            break
+    if len(args) >= 2 and args[0] == "--atlas":
+        sheet, entries = pack_atlas(args[2:])
+        write_asset(args[1], sheet, entries, key)
+        return 0
+    if len(args) != 2:
+        sys.stderr.write("usage: img2raw.py [--key RRGGBB] [--background] <input.bmp|png> "
+                         "<output.565>\n"
+                         "       img2raw.py [--key RRGGBB] --atlas <output.565> name=image ...\n")
+        return 1
+    write_asset(args[1], Image.open(args[0]), key=key, background=background)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
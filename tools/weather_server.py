@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for api.weatherapi.com, for timing fetches on the bench.
+
+Serves /v1/forecast.json and /v1/current.json over HTTP/1.1 with
+keep-alive, including bulk POSTs (q=bulk with a
+{"locations": [{"q", "custom_id"}, ...]} body).
+Responses have the same shape as the real ones (only the fields the
+firmware reads, plus some padding). forecast.json carries `days` forecast
+days of 24 hours each, from local midnight on this machine's clock.
+Build the firmware with
+  -DWEATHER_HOST='"192.168.1.50"' -DWEATHER_PORT=8080
+and compare the per-location "fetched in" log lines with
+WEATHER_REUSE_CONNECTION set to 1 and to 0.
+
+Usage:
+  python3 tools/weather_server.py [--port 8080] [--chunked] [--latency-ms 80]
+                                  [--no-bulk] [--gzip]
+"""
+
+import argparse
+import datetime
+import gzip
+import json
+import math
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+
+def local_midnight(days_ahead=0):
+    """UTC epoch of local midnight on the server's clock, as WeatherAPI's
+    time_epoch for hour 0 (the device is assumed to share its time zone)."""
+    today = datetime.date.today() + datetime.timedelta(days=days_ahead)
+    return int(time.mktime(today.timetuple()))
+
+
+def hour(seed, epoch, h):
+    return {
+        "time_epoch": epoch,
+        "time": time.strftime("%Y-%m-%d %H:%M", time.localtime(epoch)),
+        "temp_f": round(50.0 + seed % 20 + 12 * math.sin((h - 9) / 24 * 2 * math.pi), 1),
+        "wind_mph": round(4.0 + (seed + h) % 12 * 0.7, 1),
+        "pressure_in": round(29.85 + ((seed + h) % 7) / 100, 2),
+        "cloud": (seed * 7 + h * 11) % 101,
+        "chance_of_rain": (seed * 3 + h * 5) % 101,
+        "condition": {"text": "Partly cloudy", "icon": "x" * 64},
+    }
+
+
+def forecast(query, days):
+    """One location's record: current conditions and `days` forecast days
+    of 24 hours each (none for current.json)."""
+    seed = sum(map(ord, query))
+    record = {
+        "location": {"name": query.split(",")[0], "region": "", "country": "USA"},
+        "current": {
+            "last_updated_epoch": int(time.time()) // 900 * 900,
+            "temp_f": 55.0 + seed % 30,
+            "wind_mph": 3.0 + seed % 17,
+            "wind_dir": "NNW",
+            "pressure_in": 29.9 + (seed % 5) / 100,
+            "cloud": seed % 100,
+            "condition": {"text": "Partly cloudy", "icon": "x" * 64},
+        },
+    }
+    if days:
+        forecastdays = []
+        for d in range(days):
+            midnight = local_midnight(d)
+            hours = [hour(seed + d, midnight + h * 3600, h) for h in range(24)]
+            forecastdays.append({
+                "date": time.strftime("%Y-%m-%d", time.localtime(midnight)),
+                "date_epoch": midnight,
+                "day": {"daily_chance_of_rain": max(h["chance_of_rain"] for h in hours)},
+                "hour": hours,
+            })
+        record["forecast"] = {"forecastday": forecastdays}
+    return record
+
+
+def days_for(url):
+    """forecast.json's days parameter (the API's default is 1, it allows up
+    to 14); current.json has none."""
+    if url.path != ENDPOINTS[0]:
+        return 0
+    days = parse_qs(url.query).get("days", ["1"])[0]
+    return max(1, min(14, int(days))) if days.isdigit() else 1
+
+
+def accepts_gzip(headers):
+    """q-value of gzip across every Accept-Encoding line. The firmware sends
+    "gzip;q=1, identity;q=0.5" in place of the ESP32 core's own
+    "identity;q=1,chunked;q=0.1,*;q=0"; built on a core before 3.0 it can
+    only add it as a second line, so reading only the first would never
+    compress."""
+    codings = {}
+    for line in headers.get_all("Accept-Encoding") or []:
+        for item in line.split(","):
+            name, _, params = item.partition(";")
+            q = 1.0
+            for param in params.split(";"):
+                key, _, value = param.strip().partition("=")
+                if key == "q":
+                    q = float(value)
+            codings.setdefault(name.strip().lower(), q)
+    return codings.get("gzip", codings.get("*", 0)) > 0
+
+
+ENDPOINTS = ("/v1/forecast.json", "/v1/current.json")
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    connections = 0
+
+    def setup(self):
+        super().setup()
+        Handler.connections += 1
+        self.log_message("connection #%d", Handler.connections)
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        if url.path not in ENDPOINTS:
+            self.send_error(404)
+            return
+        query = parse_qs(url.query).get("q", [""])[0]
+        if not query:
+            body = {"error": {"code": 1003, "message": "Parameter q is missing."}}
+            self.reply(400, body)
+            return
+        self.reply(200, forecast(query, days_for(url)))
+
+    def do_POST(self):
+        url = urlparse(self.path)
+        query = parse_qs(url.query).get("q", [""])[0]
+        if url.path not in ENDPOINTS or query != "bulk":
+            self.send_error(404)
+            return
+        length = int(self.headers.get("Content-Length", 0))
+        request = json.loads(self.rfile.read(length) or b"{}")
+        if self.server.no_bulk:
+            body = {"error": {"code": 2009, "message": "Bulk requests are not enabled."}}
+            self.reply(403, body)
+            return
+        results = []
+        for loc in request.get("locations", []):
+            item = {"custom_id": loc.get("custom_id"), "q": loc.get("q")}
+            item.update(forecast(loc.get("q", ""), days_for(url)))
+            results.append({"query": item})
+        self.reply(200, {"bulk": results})
+
+    def reply(self, status, obj):
+        body = json.dumps(obj).encode()
+        time.sleep(self.server.latency)
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        if self.server.gzip and accepts_gzip(self.headers):
+            body = gzip.compress(body)
+            self.send_header("Content-Encoding", "gzip")
+        if self.server.chunked:
+            self.send_header("Transfer-Encoding", "chunked")
+            self.end_headers()
+            for i in range(0, len(body), 512):
+                part = body[i:i + 512]
+                self.wfile.write(b"%x\r\n%s\r\n" % (len(part), part))
+            self.wfile.write(b"0\r\n\r\n")
+        else:
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--port", type=int, default=8080)
+    ap.add_argument("--chunked", action="store_true", help="send chunked bodies")
+    ap.add_argument("--latency-ms", type=int, default=0, help="delay before each response")
+    ap.add_argument("--no-bulk", action="store_true", help="refuse bulk requests")
+    ap.add_argument("--gzip", action="store_true", help="compress when the client accepts gzip")
+    args = ap.parse_args()
+
+    server = ThreadingHTTPServer(("", args.port), Handler)
+    server.chunked = args.chunked
+    server.latency = args.latency_ms / 1000.0
+    server.no_bulk = args.no_bulk
+    server.gzip = args.gzip
+    print("listening on port %d" % args.port)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()